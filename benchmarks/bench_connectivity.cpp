@@ -0,0 +1,26 @@
+#include <catch2/catch_all.hpp>
+#include "retro_dungeon/connectivity.hpp"
+#include "retro_dungeon/random.hpp"
+
+TEST_CASE("Component labeling", "[connectivity][!benchmark]") {
+    // 55% open noise: the worst case, with a huge number of small components.
+    retro_dungeon::Map map(4096, 4096);
+    retro_dungeon::SplitMix64 rng(42);
+    for (int y = 0; y < map.getHeight(); ++y) {
+        for (int x = 0; x < map.getWidth(); ++x) {
+            if (rng() % 100 < 55) map.setTile(x, y, retro_dungeon::TileType::Floor);
+        }
+    }
+
+    retro_dungeon::ComponentLabels labels;
+
+    BENCHMARK("label 4096x4096, 1 thread") {
+        labels.build(map, 1);
+        return labels.getComponentCount();
+    };
+
+    BENCHMARK("label 4096x4096, all threads") {
+        labels.build(map);
+        return labels.getComponentCount();
+    };
+}
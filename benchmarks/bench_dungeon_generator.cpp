@@ -0,0 +1,75 @@
+#include <catch2/catch_all.hpp>
+#include "retro_dungeon/cellular_automaton.hpp"
+#include "retro_dungeon/dungeon_generator.hpp"
+#include <chrono>
+#include <cstdio>
+
+namespace {
+
+// Catch2 reports time per call; throughput is easier to compare across map
+// sizes, so each size also prints maps/sec and tiles/sec.
+void reportThroughput(int width, int height, int runs,
+                      retro_dungeon::DungeonStyle style = retro_dungeon::DungeonStyle::Rooms) {
+    retro_dungeon::DungeonGenerator gen(42);
+    std::size_t walkable = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < runs; ++i) {
+        walkable += gen.generate(width, height, style)->countWalkable();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    double mapsPerSec = runs / elapsed.count();
+    std::printf("  %dx%d: %.1f maps/sec, %.3g tiles/sec (%zu walkable)\n", width, height,
+                mapsPerSec, mapsPerSec * width * height, walkable / runs);
+}
+
+}
+
+TEST_CASE("BSP generation throughput", "[generator][!benchmark]") {
+    retro_dungeon::DungeonGenerator gen(42);
+
+    BENCHMARK("generate 60x20") {
+        return gen.generate(60, 20);
+    };
+
+    BENCHMARK("generate 512x512") {
+        return gen.generate(512, 512);
+    };
+
+    BENCHMARK("generate 4096x4096") {
+        return gen.generate(4096, 4096);
+    };
+
+    reportThroughput(60, 20, 20000);
+    reportThroughput(512, 512, 200);
+    reportThroughput(4096, 4096, 5);
+}
+
+TEST_CASE("Cave generation throughput", "[generator][!benchmark]") {
+    retro_dungeon::Bitboard walls(4096, 4096, true);
+    retro_dungeon::Bitboard next(4096, 4096, true);
+    retro_dungeon::SplitMix64 rng(42);
+    for (int y = 0; y < walls.getHeight(); ++y) {
+        for (uint64_t& word : walls.row(y)) {
+            word = rng();
+        }
+    }
+
+    BENCHMARK("one automaton step 4096x4096") {
+        retro_dungeon::stepCaveAutomaton(walls, next);
+        return next.row(0)[0];
+    };
+
+    retro_dungeon::DungeonGenerator gen(42);
+    BENCHMARK("generate caves 512x512") {
+        return gen.generate(512, 512, retro_dungeon::DungeonStyle::Caves);
+    };
+
+    BENCHMARK("generate caves 4096x4096") {
+        return gen.generate(4096, 4096, retro_dungeon::DungeonStyle::Caves);
+    };
+
+    reportThroughput(512, 512, 200, retro_dungeon::DungeonStyle::Caves);
+    reportThroughput(4096, 4096, 5, retro_dungeon::DungeonStyle::Caves);
+}
@@ -0,0 +1,72 @@
+#include <catch2/catch_all.hpp>
+#include "retro_dungeon/enemy.hpp"
+#include "retro_dungeon/random.hpp"
+#include <memory>
+#include <vector>
+
+TEST_CASE("Enemy turn update", "[enemy][!benchmark]") {
+    // One turn for a million enemies: poison ticks, and everyone still
+    // standing with any attack left steps east.
+    constexpr int COUNT = 1'000'000;
+    std::vector<std::unique_ptr<retro_dungeon::Enemy>> objects;
+    retro_dungeon::EnemyStore store;
+    retro_dungeon::SplitMix64 rng(11);
+    objects.reserve(COUNT);
+    for (int i = 0; i < COUNT; ++i) {
+        const auto type = static_cast<retro_dungeon::EnemyType>(retro_dungeon::uniformInt(rng, 0, 6));
+        const retro_dungeon::Position pos{i % 1000, i / 1000};
+        objects.push_back(std::make_unique<retro_dungeon::Enemy>(i + 1, type, pos));
+        store.create(type, pos);
+    }
+
+    BENCHMARK("vector<unique_ptr<Enemy>>") {
+        int alive = 0;
+        for (auto& e : objects) {
+            e->takeDamage(1);
+            if (e->isAlive() && e->attackPower > 0) {
+                e->pos.first += 1;
+                ++alive;
+            }
+        }
+        return alive;
+    };
+
+    BENCHMARK("EnemyStore columns") {
+        int alive = 0;
+        auto health = store.health();
+        auto attack = store.attack();
+        auto positions = store.positions();
+        for (std::size_t i = 0; i < store.size(); ++i) {
+            health[i] -= 1;
+            if (health[i] > 0 && attack[i] > 0) {
+                positions[i].first += 1;
+                ++alive;
+            }
+        }
+        return alive;
+    };
+}
+
+TEST_CASE("Enemy death processing", "[enemy][!benchmark]") {
+    // Every turn a tenth of a million enemies die and as many respawn.
+    constexpr int COUNT = 1'000'000;
+    retro_dungeon::EnemyStore store;
+    for (int i = 0; i < COUNT; ++i) {
+        store.create(retro_dungeon::EnemyType::Orc, {i % 1000, i / 1000});
+    }
+    std::vector<retro_dungeon::EnemyDeath> deaths;
+    retro_dungeon::SplitMix64 rng(5);
+
+    BENCHMARK("kill 10%, compact, respawn") {
+        auto health = store.health();
+        for (std::size_t i = 0; i < health.size(); ++i) {
+            if (rng() % 10 == 0) health[i] = 0;
+        }
+        deaths.clear();
+        store.removeDead(deaths);
+        for (const auto& death : deaths) {
+            store.create(death.type, death.pos);
+        }
+        return deaths.size();
+    };
+}
@@ -0,0 +1,73 @@
+#include <catch2/catch_all.hpp>
+#include "retro_dungeon/dungeon_generator.hpp"
+#include "retro_dungeon/field_of_view.hpp"
+#include "retro_dungeon/random.hpp"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace {
+
+using retro_dungeon::Map;
+using retro_dungeon::Position;
+
+constexpr int SIZE = 256;
+constexpr int RADIUS = 20;
+constexpr int ORIGIN_COUNT = 1000;
+
+// "open": one big room, the worst case for the number of visible tiles.
+// "pillars": the same room with one tile in ten a wall, the worst case for
+// recursion.
+std::unique_ptr<Map> makeMap(const char* kind) {
+    retro_dungeon::DungeonGenerator generator(42);
+    if (kind[0] == 'c') return generator.generate(SIZE, SIZE, retro_dungeon::DungeonStyle::Caves);
+    if (kind[0] == 'r') return generator.generate(SIZE, SIZE, retro_dungeon::DungeonStyle::Rooms);
+
+    auto map = std::make_unique<Map>(SIZE, SIZE);
+    map->fillRect(1, 1, SIZE - 2, SIZE - 2, retro_dungeon::TileType::Floor);
+    if (kind[0] == 'p') {
+        retro_dungeon::SplitMix64 rng(42);
+        for (int y = 1; y < SIZE - 1; ++y) {
+            for (int x = 1; x < SIZE - 1; ++x) {
+                if (rng() % 10 == 0) map->setTile(x, y, retro_dungeon::TileType::Wall);
+            }
+        }
+    }
+    return map;
+}
+
+}
+
+TEST_CASE("Shadowcasting FOV at radius 20 on 256x256 maps", "[field_of_view][!benchmark]") {
+    for (const char* kind : {"open", "pillars", "caves", "rooms"}) {
+        auto map = makeMap(kind);
+        map->trackWalkableCells();
+        const auto cells = map->walkableCells();
+        retro_dungeon::SplitMix64 rng(7);
+        std::vector<Position> origins;
+        for (int i = 0; i < ORIGIN_COUNT; ++i) {
+            origins.push_back(map->cellPosition(cells[retro_dungeon::uniformInt(rng, 0, static_cast<int>(cells.size()) - 1)]));
+        }
+
+        retro_dungeon::FieldOfView fov;
+        std::size_t visible = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < 10; ++round) {
+            for (Position origin : origins) fov.compute(*map, origin, RADIUS);
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        for (Position origin : origins) {
+            fov.compute(*map, origin, RADIUS);
+            visible += map->countVisible();
+        }
+        std::printf("%s: %.2f us/FOV, %zu visible tiles/FOV\n", kind, elapsed.count() * 1e6 / (10.0 * ORIGIN_COUNT),
+                    visible / ORIGIN_COUNT);
+
+        std::size_t next = 0;
+        BENCHMARK(std::string("FOV ") + kind) {
+            fov.compute(*map, origins[next++ % origins.size()], RADIUS);
+            return fov.getBoundsWidth();
+        };
+    }
+}
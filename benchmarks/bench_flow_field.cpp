@@ -0,0 +1,62 @@
+#include <catch2/catch_all.hpp>
+#include "retro_dungeon/dungeon_generator.hpp"
+#include "retro_dungeon/flow_field.hpp"
+#include "retro_dungeon/pathfinder.hpp"
+#include "retro_dungeon/spawn_sampler.hpp"
+#include <vector>
+
+TEST_CASE("Mass chase movement", "[flow_field][!benchmark]") {
+    // 500 enemies on a 256x256 cave level chasing a player who walks back
+    // and forth between two tiles.
+    retro_dungeon::DungeonGenerator generator(23);
+    auto map = generator.generate(256, 256, retro_dungeon::DungeonStyle::Caves);
+    map->trackWalkableCells();
+    retro_dungeon::SpawnSampler spawns;
+    spawns.reset(*map);
+    retro_dungeon::SplitMix64 rng(4);
+    std::vector<retro_dungeon::Position> enemies(500);
+    spawns.sampleBatch(rng, enemies);
+
+    retro_dungeon::Position player = map->getSpawnPoint();
+    retro_dungeon::Position other = player;
+    for (auto p : {retro_dungeon::Position{1, 0}, {-1, 0}, {0, 1}, {0, -1}}) {
+        if (map->isWalkable(player.first + p.first, player.second + p.second)) {
+            other = {player.first + p.first, player.second + p.second};
+        }
+    }
+    int turn = 0;
+    auto playerPos = [&] { return turn % 2 == 0 ? player : other; };
+
+    retro_dungeon::Pathfinder pathfinder;
+    std::vector<retro_dungeon::Position> path;
+    BENCHMARK("A* per enemy") {
+        ++turn;
+        int moved = 0;
+        for (auto p : enemies) moved += pathfinder.findPath(*map, p, playerPos(), path);
+        return moved;
+    };
+
+    retro_dungeon::FlowField field;
+    BENCHMARK("full flow field + downhill") {
+        ++turn;
+        const auto target = playerPos();
+        field.compute(*map, {&target, 1});
+        int moved = 0;
+        for (auto p : enemies) moved += field.downhill(p) != p;
+        return moved;
+    };
+
+    BENCHMARK("followed flow field + downhill") {
+        ++turn;
+        field.follow(*map, playerPos());
+        int moved = 0;
+        for (auto p : enemies) moved += field.downhill(p) != p;
+        return moved;
+    };
+
+    retro_dungeon::FlowField flee;
+    BENCHMARK("flee field") {
+        flee.computeFlee(*map, field);
+        return flee.valueAt(player);
+    };
+}
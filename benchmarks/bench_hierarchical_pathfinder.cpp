@@ -0,0 +1,121 @@
+#include <catch2/catch_all.hpp>
+#include "retro_dungeon/dungeon_generator.hpp"
+#include "retro_dungeon/hierarchical_pathfinder.hpp"
+#include "retro_dungeon/pathfinder.hpp"
+#include "retro_dungeon/random.hpp"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using retro_dungeon::Map;
+using retro_dungeon::Position;
+
+constexpr int SIZE = 4096;
+constexpr int QUERY_COUNT = 200;
+constexpr int ASTAR_QUERY_COUNT = 10;
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Connected pairs of walkable tiles anywhere on the map, so most cross a
+// few thousand tiles.
+std::vector<std::pair<Position, Position>> makeQueries(Map& map, retro_dungeon::HierarchicalPathfinder& hpa,
+                                                       uint64_t seed) {
+    map.trackWalkableCells();
+    const auto cells = map.walkableCells();
+    retro_dungeon::SplitMix64 rng(seed);
+    std::vector<Position> waypoints;
+    std::vector<std::pair<Position, Position>> queries;
+    const int last = static_cast<int>(cells.size()) - 1;
+    while (static_cast<int>(queries.size()) < QUERY_COUNT) {
+        const Position start = map.cellPosition(cells[retro_dungeon::uniformInt(rng, 0, last)]);
+        const Position goal = map.cellPosition(cells[retro_dungeon::uniformInt(rng, 0, last)]);
+        if (hpa.findPath(map, start, goal, waypoints)) queries.emplace_back(start, goal);
+    }
+    return queries;
+}
+
+}
+
+TEST_CASE("HPA* and A* on 4096x4096 cave and room maps", "[hierarchical_pathfinder][!benchmark]") {
+    retro_dungeon::DungeonGenerator generator(42);
+    for (auto style : {retro_dungeon::DungeonStyle::Caves, retro_dungeon::DungeonStyle::Rooms}) {
+        const char* kind = style == retro_dungeon::DungeonStyle::Caves ? "caves" : "rooms";
+        auto map = generator.generate(SIZE, SIZE, style);
+
+        retro_dungeon::HierarchicalPathfinder hpa;
+        auto start = std::chrono::steady_clock::now();
+        hpa.sync(*map);
+        std::printf("%s: graph build %.0f ms, %zu clusters, %zu nodes\n", kind, secondsSince(start) * 1e3,
+                    hpa.getClusterCount(), hpa.getNodeCount());
+
+        const auto queries = makeQueries(*map, hpa, 7);
+        std::vector<Position> waypoints;
+        std::vector<Position> steps;
+        std::size_t expanded = 0;
+        long length = 0;
+        start = std::chrono::steady_clock::now();
+        for (const auto& [from, to] : queries) {
+            hpa.findPath(*map, from, to, waypoints);
+            expanded += hpa.getExpandedCount();
+            length += hpa.getPathLength();
+        }
+        const double abstract = secondsSince(start) / QUERY_COUNT;
+        std::printf("  HPA* findPath: %.1f us/query, %zu expanded/query, %ld steps/query\n", abstract * 1e6,
+                    expanded / QUERY_COUNT, length / QUERY_COUNT);
+
+        // A mover only refines the stretch it is about to walk.
+        const auto& [from, to] = queries[0];
+        hpa.findPath(*map, from, to, waypoints);
+        start = std::chrono::steady_clock::now();
+        hpa.refine(*map, from, waypoints[0], steps);
+        std::printf("  HPA* refine one stretch: %.1f us\n", secondsSince(start) * 1e6);
+
+        retro_dungeon::Pathfinder astar;
+        std::vector<Position> path;
+        long optimal = 0;
+        long hierarchical = 0;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < ASTAR_QUERY_COUNT; ++i) {
+            astar.findPath(*map, queries[i].first, queries[i].second, path);
+            optimal += static_cast<long>(path.size());
+        }
+        const double full = secondsSince(start) / ASTAR_QUERY_COUNT;
+        for (int i = 0; i < ASTAR_QUERY_COUNT; ++i) {
+            hpa.findPath(*map, queries[i].first, queries[i].second, waypoints);
+            hierarchical += hpa.getPathLength();
+        }
+        std::printf("  A*: %.0f us/query (%.0fx HPA*), HPA* paths %.1f%% longer\n", full * 1e6, full / abstract,
+                    100.0 * (hierarchical - optimal) / optimal);
+
+        std::size_t next = 0;
+        BENCHMARK(std::string("HPA* ") + kind + ", anywhere") {
+            const auto& [a, b] = queries[next++ % queries.size()];
+            return hpa.findPath(*map, a, b, waypoints);
+        };
+    }
+}
+
+TEST_CASE("HPA* graph maintenance", "[hierarchical_pathfinder][!benchmark]") {
+    // One tile toggled per sync, as when a door opens: one or two 64x64
+    // clusters are rebuilt instead of the 4096 in the whole graph.
+    retro_dungeon::DungeonGenerator generator(42);
+    auto map = generator.generate(SIZE, SIZE, retro_dungeon::DungeonStyle::Caves);
+    retro_dungeon::HierarchicalPathfinder hpa;
+    hpa.sync(*map);
+    retro_dungeon::SplitMix64 rng(5);
+
+    BENCHMARK("setTile + sync") {
+        const int x = retro_dungeon::uniformInt(rng, 1, SIZE - 2);
+        const int y = retro_dungeon::uniformInt(rng, 1, SIZE - 2);
+        map->setTile(x, y, map->isWalkable(x, y) ? retro_dungeon::TileType::Wall
+                                                 : retro_dungeon::TileType::Floor);
+        hpa.sync(*map);
+        return hpa.getClusterRebuildCount();
+    };
+}
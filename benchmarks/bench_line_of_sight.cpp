@@ -0,0 +1,114 @@
+#include <catch2/catch_all.hpp>
+#include "retro_dungeon/dungeon_generator.hpp"
+#include "retro_dungeon/field_of_view.hpp"
+#include "retro_dungeon/line_of_sight.hpp"
+#include "retro_dungeon/random.hpp"
+#include "retro_dungeon/spawn_sampler.hpp"
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+using retro_dungeon::Position;
+
+// The per-pair baseline: walk the Bresenham line tile by tile.
+bool walkLine(const retro_dungeon::Map& map, Position a, Position b) {
+    const int dx = std::abs(b.first - a.first);
+    const int dy = -std::abs(b.second - a.second);
+    const int sx = a.first < b.first ? 1 : -1;
+    const int sy = a.second < b.second ? 1 : -1;
+    int err = dx + dy;
+    while (a != b) {
+        const int twice = 2 * err;
+        if (twice >= dy) {
+            err += dy;
+            a.first += sx;
+        }
+        if (twice <= dx) {
+            err += dx;
+            a.second += sy;
+        }
+        if (a != b && !map.isWalkable(a.first, a.second)) return false;
+    }
+    return true;
+}
+
+}
+
+TEST_CASE("Monsters looking for the player", "[line_of_sight][!benchmark]") {
+    // 500 monsters on a 256x256 cave level, all within LineOfSight::RANGE
+    // of the player, which moves every turn.
+    retro_dungeon::DungeonGenerator generator(23);
+    auto map = generator.generate(256, 256, retro_dungeon::DungeonStyle::Caves);
+    map->trackWalkableCells();
+    const auto cells = map->walkableCells();
+    retro_dungeon::SplitMix64 rng(4);
+
+    std::vector<Position> players;
+    std::vector<std::vector<Position>> monsters;
+    for (int turn = 0; turn < 64; ++turn) {
+        const Position player = map->cellPosition(cells[retro_dungeon::uniformInt(rng, 0, static_cast<int>(cells.size()) - 1)]);
+        std::vector<Position> around;
+        while (around.size() < 500) {
+            const Position p{player.first + retro_dungeon::uniformInt(rng, -15, 15),
+                             player.second + retro_dungeon::uniformInt(rng, -15, 15)};
+            if (map->isWalkable(p.first, p.second)) around.push_back(p);
+        }
+        players.push_back(player);
+        monsters.push_back(std::move(around));
+    }
+
+    std::vector<uint8_t> results(500);
+    std::size_t turn = 0;
+    BENCHMARK("walk each line, 500 monsters") {
+        const std::size_t t = turn++ % players.size();
+        int seen = 0;
+        for (Position p : monsters[t]) seen += walkLine(*map, p, players[t]);
+        return seen;
+    };
+
+    retro_dungeon::LineOfSight sight;
+    BENCHMARK("batched bitboard test, 500 monsters") {
+        const std::size_t t = turn++ % players.size();
+        sight.canSee(*map, monsters[t], players[t], results);
+        return results[0];
+    };
+}
+
+TEST_CASE("Cached monster views", "[line_of_sight][!benchmark]") {
+    // 500 resting monsters with radius 8 views while a door far from most
+    // of them opens and closes every turn.
+    retro_dungeon::DungeonGenerator generator(23);
+    auto map = generator.generate(256, 256, retro_dungeon::DungeonStyle::Caves);
+    map->trackWalkableCells();
+    retro_dungeon::SpawnSampler spawns;
+    spawns.reset(*map);
+    retro_dungeon::SplitMix64 rng(4);
+    std::vector<Position> monsters(500);
+    spawns.sampleBatch(rng, monsters);
+    const Position door = map->getSpawnPoint();
+
+    retro_dungeon::FieldOfView fov;
+    BENCHMARK("observe every view every turn") {
+        int seen = 0;
+        for (Position p : monsters) {
+            fov.observe(*map, p, 8);
+            seen += fov.sees(door);
+        }
+        return seen;
+    };
+
+    std::vector<retro_dungeon::ObserverView> views(monsters.size());
+    for (std::size_t i = 0; i < monsters.size(); ++i) views[i].update(*map, monsters[i], 8);
+    int turn = 0;
+    BENCHMARK("ObserverView, door toggling") {
+        map->setTile(door.first, door.second,
+                     ++turn % 2 ? retro_dungeon::TileType::Wall : retro_dungeon::TileType::Door);
+        int seen = 0;
+        for (std::size_t i = 0; i < monsters.size(); ++i) {
+            views[i].update(*map, monsters[i], 8);
+            seen += views[i].sees(door);
+        }
+        return seen;
+    };
+}
@@ -0,0 +1,96 @@
+#include <catch2/catch_all.hpp>
+#include "retro_dungeon/map.hpp"
+#include <random>
+#include <string>
+#include <vector>
+
+using retro_dungeon::Map;
+using retro_dungeon::Tile;
+using retro_dungeon::TileType;
+
+namespace {
+
+// The vector-of-vectors of Tile layout Map used before it moved to flat layers.
+struct NestedTiles {
+    std::vector<std::vector<Tile>> rows;
+
+    NestedTiles(int w, int h) : rows(h, std::vector<Tile>(w, Map::makeTile(TileType::Wall))) {}
+
+    const Tile& get(int x, int y) const { return rows[y][x]; }
+};
+
+std::vector<std::pair<int, int>> randomCoords(int w, int h, int count) {
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> xDist(0, w - 1);
+    std::uniform_int_distribution<int> yDist(0, h - 1);
+    std::vector<std::pair<int, int>> coords(count);
+    for (auto& c : coords) {
+        c = {xDist(rng), yDist(rng)};
+    }
+    return coords;
+}
+
+void carveCheckerboard(Map& map, NestedTiles& nested) {
+    for (int y = 0; y < map.getHeight(); ++y) {
+        for (int x = (y & 1); x < map.getWidth(); x += 2) {
+            map.setTile(x, y, TileType::Floor);
+            nested.rows[y][x] = Map::makeTile(TileType::Floor);
+        }
+    }
+}
+
+void benchmarkLayouts(int w, int h) {
+    Map map(w, h);
+    NestedTiles nested(w, h);
+    carveCheckerboard(map, nested);
+    const auto coords = randomCoords(w, h, 4096);
+    const std::string size = std::to_string(w) + "x" + std::to_string(h);
+
+    BENCHMARK("nested sweep " + size) {
+        int walkable = 0;
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                walkable += nested.get(x, y).walkable;
+            }
+        }
+        return walkable;
+    };
+
+    BENCHMARK("flat sweep " + size) {
+        int walkable = 0;
+        for (int y = 0; y < h; ++y) {
+            for (TileType type : map.typeRow(y)) {
+                walkable += retro_dungeon::tileTraits(type).walkable;
+            }
+        }
+        return walkable;
+    };
+
+    BENCHMARK("bitplane popcount " + size) {
+        return map.countWalkable();
+    };
+
+    BENCHMARK("nested random access " + size) {
+        int walkable = 0;
+        for (auto [x, y] : coords) {
+            walkable += nested.get(x, y).walkable;
+        }
+        return walkable;
+    };
+
+    BENCHMARK("flat random access " + size) {
+        int walkable = 0;
+        for (auto [x, y] : coords) {
+            walkable += map.isWalkable(x, y);
+        }
+        return walkable;
+    };
+}
+
+}
+
+TEST_CASE("Map layout sweeps and random access", "[map][!benchmark]") {
+    benchmarkLayouts(60, 20);
+    benchmarkLayouts(512, 512);
+    benchmarkLayouts(4096, 4096);
+}
@@ -0,0 +1,174 @@
+#include <catch2/catch_all.hpp>
+#include "retro_dungeon/dungeon_generator.hpp"
+#include "retro_dungeon/jump_point_search.hpp"
+#include "retro_dungeon/pathfinder.hpp"
+#include "retro_dungeon/random.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using retro_dungeon::Map;
+using retro_dungeon::Position;
+
+constexpr int SIZE = 256;
+constexpr int QUERY_COUNT = 1000;
+constexpr int SHORT_RANGE = 16;
+
+// Perfect maze by iterative recursive backtracking: cells on odd
+// coordinates, one-tile walls between them.
+std::unique_ptr<Map> makeMaze(int width, int height, uint64_t seed) {
+    auto map = std::make_unique<Map>(width, height);
+    retro_dungeon::SplitMix64 rng(seed);
+    std::vector<Position> stack{{1, 1}};
+    map->setTile(1, 1, retro_dungeon::TileType::Floor);
+    constexpr int DX[] = {2, -2, 0, 0};
+    constexpr int DY[] = {0, 0, 2, -2};
+    while (!stack.empty()) {
+        const auto [x, y] = stack.back();
+        int options[4];
+        int count = 0;
+        for (int d = 0; d < 4; ++d) {
+            const int nx = x + DX[d];
+            const int ny = y + DY[d];
+            if (nx > 0 && nx < width - 1 && ny > 0 && ny < height - 1 &&
+                map->getTileType(nx, ny) == retro_dungeon::TileType::Wall) {
+                options[count++] = d;
+            }
+        }
+        if (count == 0) {
+            stack.pop_back();
+            continue;
+        }
+        const int d = options[retro_dungeon::uniformInt(rng, 0, count - 1)];
+        map->setTile(x + DX[d] / 2, y + DY[d] / 2, retro_dungeon::TileType::Floor);
+        map->setTile(x + DX[d], y + DY[d], retro_dungeon::TileType::Floor);
+        stack.push_back({x + DX[d], y + DY[d]});
+    }
+    return map;
+}
+
+std::unique_ptr<Map> makeMap(const char* kind) {
+    retro_dungeon::DungeonGenerator generator(42);
+    if (kind[0] == 'm') return makeMaze(SIZE, SIZE, 42);
+    if (kind[0] == 'c') return generator.generate(SIZE, SIZE, retro_dungeon::DungeonStyle::Caves);
+    return generator.generate(SIZE, SIZE, retro_dungeon::DungeonStyle::Rooms);
+}
+
+// Connected start/goal pairs on walkable tiles. With maxDistance > 0 the
+// goal is at most that many tiles (Manhattan) from the start, as for an
+// enemy chasing a nearby player.
+std::vector<std::pair<Position, Position>> makeQueries(Map& map, int maxDistance, uint64_t seed) {
+    map.trackWalkableCells();
+    const auto cells = map.walkableCells();
+    retro_dungeon::SplitMix64 rng(seed);
+    retro_dungeon::Pathfinder pathfinder;
+    std::vector<Position> path;
+    std::vector<std::pair<Position, Position>> queries;
+    const int last = static_cast<int>(cells.size()) - 1;
+    while (static_cast<int>(queries.size()) < QUERY_COUNT) {
+        const Position start = map.cellPosition(cells[retro_dungeon::uniformInt(rng, 0, last)]);
+        Position goal = map.cellPosition(cells[retro_dungeon::uniformInt(rng, 0, last)]);
+        if (maxDistance > 0) {
+            goal = {start.first + retro_dungeon::uniformInt(rng, -maxDistance, maxDistance),
+                    start.second + retro_dungeon::uniformInt(rng, -maxDistance, maxDistance)};
+            if (std::abs(goal.first - start.first) + std::abs(goal.second - start.second) > maxDistance) {
+                continue;
+            }
+        }
+        if (!pathfinder.findPath(map, start, goal, path)) continue;
+        queries.emplace_back(start, goal);
+    }
+    return queries;
+}
+
+// Runs every query `rounds` times and prints queries/sec and the mean
+// number of expanded nodes per query.
+template <typename Search>
+void reportQueries(const char* label, const Map& map,
+                   const std::vector<std::pair<Position, Position>>& queries, int rounds) {
+    Search pathfinder;
+    std::vector<Position> path;
+    // Untimed first query: JumpPointSearch builds its tables here.
+    pathfinder.findPath(map, queries[0].first, queries[0].second, path);
+    std::size_t expanded = 0;
+    std::size_t found = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (const auto& [from, to] : queries) {
+            found += pathfinder.findPath(map, from, to, path);
+            expanded += pathfinder.getExpandedCount();
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    const double count = static_cast<double>(queries.size()) * rounds;
+    std::printf("  %s: %.0f queries/sec, %.0f expanded/query (%zu found)\n", label,
+                count / elapsed.count(), expanded / count, found);
+}
+
+}
+
+TEST_CASE("A* and JPS on 256x256 maze, cave and room maps", "[pathfinder][!benchmark]") {
+    for (const char* kind : {"maze", "caves", "rooms"}) {
+        auto map = makeMap(kind);
+        const auto nearby = makeQueries(*map, SHORT_RANGE, 7);
+        const auto anywhere = makeQueries(*map, 0, 11);
+
+        retro_dungeon::Pathfinder astar;
+        retro_dungeon::JumpPointSearch jps;
+        std::vector<Position> path;
+        std::size_t next = 0;
+        BENCHMARK(std::string("A* ") + kind + ", within 16 tiles") {
+            const auto& [from, to] = nearby[next++ % nearby.size()];
+            return astar.findPath(*map, from, to, path);
+        };
+        BENCHMARK(std::string("JPS ") + kind + ", within 16 tiles") {
+            const auto& [from, to] = nearby[next++ % nearby.size()];
+            return jps.findPath(*map, from, to, path);
+        };
+        BENCHMARK(std::string("A* ") + kind + ", anywhere") {
+            const auto& [from, to] = anywhere[next++ % anywhere.size()];
+            return astar.findPath(*map, from, to, path);
+        };
+        BENCHMARK(std::string("JPS ") + kind + ", anywhere") {
+            const auto& [from, to] = anywhere[next++ % anywhere.size()];
+            return jps.findPath(*map, from, to, path);
+        };
+
+        std::printf("%s:\n", kind);
+        reportQueries<retro_dungeon::Pathfinder>("A* within 16 tiles", *map, nearby, 20);
+        reportQueries<retro_dungeon::JumpPointSearch>("JPS within 16 tiles", *map, nearby, 20);
+        reportQueries<retro_dungeon::Pathfinder>("A* anywhere", *map, anywhere, 1);
+        reportQueries<retro_dungeon::JumpPointSearch>("JPS anywhere", *map, anywhere, 1);
+    }
+}
+
+TEST_CASE("JPS table maintenance", "[pathfinder][!benchmark]") {
+    // One tile toggled per query, as when a door opens: the patch touches
+    // three rows and a few columns instead of the whole 256x256 table.
+    auto map = makeMap("caves");
+    retro_dungeon::JumpPointSearch jps;
+    jps.sync(*map);
+    retro_dungeon::SplitMix64 rng(5);
+
+    BENCHMARK("setTile + patch") {
+        const int x = retro_dungeon::uniformInt(rng, 1, SIZE - 2);
+        const int y = retro_dungeon::uniformInt(rng, 1, SIZE - 2);
+        map->setTile(x, y, map->isWalkable(x, y) ? retro_dungeon::TileType::Wall
+                                                 : retro_dungeon::TileType::Floor);
+        jps.sync(*map);
+        return jps.getPatchedTileCount();
+    };
+
+    BENCHMARK("full table rebuild") {
+        retro_dungeon::JumpPointSearch fresh;
+        fresh.sync(*map);
+        return fresh.getRebuildCount();
+    };
+}
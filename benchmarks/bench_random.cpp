@@ -0,0 +1,102 @@
+#include <catch2/catch_all.hpp>
+#include "retro_dungeon/dungeon_generator.hpp"
+#include "retro_dungeon/random.hpp"
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr int SPAWN_DRAWS = 1000;
+
+// Mirrors the draws Game::spawnEnemies makes per enemy: x, y and type.
+template <typename Engine>
+int spawnWithDistributions(Engine& rng) {
+    int checksum = 0;
+    for (int i = 0; i < SPAWN_DRAWS; ++i) {
+        std::uniform_int_distribution<int> xDist(1, 58);
+        std::uniform_int_distribution<int> yDist(1, 18);
+        std::uniform_int_distribution<int> typeDist(0, 6);
+        checksum += xDist(rng) + yDist(rng) + typeDist(rng);
+    }
+    return checksum;
+}
+
+template <typename Engine>
+int spawnWithLemire(Engine& rng) {
+    int checksum = 0;
+    for (int i = 0; i < SPAWN_DRAWS; ++i) {
+        checksum += retro_dungeon::uniformInt(rng, 1, 58) + retro_dungeon::uniformInt(rng, 1, 18) +
+                    retro_dungeon::uniformInt(rng, 0, 6);
+    }
+    return checksum;
+}
+
+}
+
+TEST_CASE("RNG engines in the spawn path", "[random][!benchmark]") {
+    std::mt19937 mt(42);
+    retro_dungeon::Xoshiro256StarStar xoshiro(42);
+    retro_dungeon::SplitMix64 splitmix(42);
+
+    BENCHMARK("mt19937 + uniform_int_distribution") {
+        return spawnWithDistributions(mt);
+    };
+
+    BENCHMARK("mt19937 + Lemire") {
+        return spawnWithLemire(mt);
+    };
+
+    BENCHMARK("xoshiro256** + Lemire") {
+        return spawnWithLemire(xoshiro);
+    };
+
+    BENCHMARK("SplitMix64 + Lemire") {
+        return spawnWithLemire(splitmix);
+    };
+}
+
+TEST_CASE("RNG engines in the generation path", "[random][!benchmark]") {
+    BENCHMARK("construct mt19937 generator") {
+        return retro_dungeon::BasicDungeonGenerator<std::mt19937>(42).getSeed();
+    };
+
+    BENCHMARK("construct xoshiro256** generator") {
+        return retro_dungeon::DungeonGenerator(42).getSeed();
+    };
+
+    retro_dungeon::BasicDungeonGenerator<std::mt19937> mtGenerator(42);
+    retro_dungeon::DungeonGenerator xoshiroGenerator(42);
+
+    BENCHMARK("generate 60x20 with mt19937") {
+        return mtGenerator.generate(60, 20);
+    };
+
+    BENCHMARK("generate 60x20 with xoshiro256**") {
+        return xoshiroGenerator.generate(60, 20);
+    };
+}
+
+TEST_CASE("Batch vs scalar bounded draws", "[random][!benchmark]") {
+    constexpr std::size_t COUNT = 4096;
+    retro_dungeon::Xoshiro256StarStar xoshiro(42);
+    retro_dungeon::BatchRng batch(42);
+    std::vector<int> ints(COUNT);
+    std::vector<float> floats(COUNT);
+
+    BENCHMARK("xoshiro256** uniformInt x4096") {
+        for (int& value : ints) {
+            value = retro_dungeon::uniformInt(xoshiro, 0, 99);
+        }
+        return ints.back();
+    };
+
+    BENCHMARK("BatchRng fillInts x4096") {
+        batch.fillInts(ints, 0, 99);
+        return ints.back();
+    };
+
+    BENCHMARK("BatchRng fillFloats x4096") {
+        batch.fillFloats(floats);
+        return floats.back();
+    };
+}
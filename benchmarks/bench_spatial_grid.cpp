@@ -0,0 +1,65 @@
+#include <catch2/catch_all.hpp>
+#include "retro_dungeon/random.hpp"
+#include "retro_dungeon/spatial_grid.hpp"
+#include <vector>
+
+namespace {
+
+struct Monster {
+    retro_dungeon::Position pos;
+    int health;
+};
+
+}
+
+TEST_CASE("Enemy lookup by tile", "[spatial_grid][!benchmark]") {
+    // A stress dungeon: 4000 monsters on a 512x512 level.
+    constexpr int SIZE = 512;
+    std::vector<Monster> monsters;
+    retro_dungeon::SpatialGrid<Monster*> grid(SIZE, SIZE);
+    retro_dungeon::SplitMix64 rng(7);
+    monsters.reserve(4000);
+    while (monsters.size() < 4000) {
+        retro_dungeon::Position p{retro_dungeon::uniformInt(rng, 0, SIZE - 1),
+                                  retro_dungeon::uniformInt(rng, 0, SIZE - 1)};
+        if (grid.isOccupied(p)) continue;
+        monsters.push_back({p, 10});
+        grid.place(p, &monsters.back());
+    }
+
+    std::vector<retro_dungeon::Position> queries;
+    for (int i = 0; i < 1024; ++i) {
+        queries.push_back({retro_dungeon::uniformInt(rng, 0, SIZE - 1),
+                           retro_dungeon::uniformInt(rng, 0, SIZE - 1)});
+    }
+
+    BENCHMARK("linear scan, 1024 lookups") {
+        int hits = 0;
+        for (auto q : queries) {
+            for (const Monster& m : monsters) {
+                if (m.pos == q && m.health > 0) {
+                    ++hits;
+                    break;
+                }
+            }
+        }
+        return hits;
+    };
+
+    BENCHMARK("grid, 1024 lookups") {
+        int hits = 0;
+        for (auto q : queries) {
+            const Monster* m = grid.at(q);
+            hits += m && m->health > 0;
+        }
+        return hits;
+    };
+
+    BENCHMARK("grid, 1024 radius-8 queries") {
+        int hits = 0;
+        for (auto q : queries) {
+            grid.forEachInRadius(q, 8, [&](retro_dungeon::Position, const Monster*) { ++hits; });
+        }
+        return hits;
+    };
+}
@@ -0,0 +1,33 @@
+#include <catch2/catch_all.hpp>
+#include "retro_dungeon/dungeon_generator.hpp"
+#include "retro_dungeon/spawn_sampler.hpp"
+#include "retro_dungeon/spatial_grid.hpp"
+#include <vector>
+
+TEST_CASE("Mass spawn placement", "[spawn_sampler][!benchmark]") {
+    // 20k entities on a 1024x1024 cave level, without two on one tile.
+    retro_dungeon::DungeonGenerator generator(17);
+    auto map = generator.generate(1024, 1024, retro_dungeon::DungeonStyle::Caves);
+    map->trackWalkableCells();
+    constexpr int COUNT = 20'000;
+    retro_dungeon::SplitMix64 rng(9);
+
+    BENCHMARK("rejection sampling over the whole map") {
+        retro_dungeon::SpatialGrid<int> taken(map->getWidth(), map->getHeight());
+        int placed = 0;
+        while (placed < COUNT) {
+            const retro_dungeon::Position p{retro_dungeon::uniformInt(rng, 0, map->getWidth() - 1),
+                                            retro_dungeon::uniformInt(rng, 0, map->getHeight() - 1)};
+            if (!map->isWalkable(p.first, p.second) || !taken.place(p, 1)) continue;
+            ++placed;
+        }
+        return placed;
+    };
+
+    retro_dungeon::SpawnSampler sampler;
+    std::vector<retro_dungeon::Position> out(COUNT);
+    BENCHMARK("spawn sampler batch") {
+        sampler.reset(*map);
+        return sampler.sampleBatch(rng, out);
+    };
+}
@@ -0,0 +1,63 @@
+#ifndef RETRO_DUNGEON_CELLULAR_AUTOMATON_HPP
+#define RETRO_DUNGEON_CELLULAR_AUTOMATON_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace retro_dungeon {
+
+// One bit per tile, packed like Map's bitplanes: bit x & 63 of word x / 64,
+// rows padded to whole words. Every row also has a guard word on each side
+// and there is a guard row above and below the board; guards and padding
+// bits always read as `outside`, so neighbour lookups never need bounds
+// checks.
+class Bitboard {
+public:
+    Bitboard(int width, int height, bool outside = false);
+
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+    int getWordsPerRow() const { return m_wordsPerRow; }
+
+    std::span<uint64_t> row(int y) { return {rowData(y), static_cast<std::size_t>(m_wordsPerRow)}; }
+    std::span<const uint64_t> row(int y) const {
+        return {rowData(y), static_cast<std::size_t>(m_wordsPerRow)};
+    }
+
+    bool test(int x, int y) const;
+    void set(int x, int y, bool value);
+    std::size_t count() const;
+
+    // Restores the padding bits after whole words were written through row().
+    void resetPadding();
+
+private:
+    int m_width;
+    int m_height;
+    int m_wordsPerRow;
+    int m_pitch;
+    uint64_t m_outside;
+    uint64_t m_lastWordMask;
+    std::vector<uint64_t> m_bits;
+
+    uint64_t* rowData(int y) { return m_bits.data() + static_cast<std::size_t>(y + 1) * m_pitch + 1; }
+    const uint64_t* rowData(int y) const {
+        return m_bits.data() + static_cast<std::size_t>(y + 1) * m_pitch + 1;
+    }
+
+    friend void stepCaveAutomaton(const Bitboard& walls, Bitboard& next);
+};
+
+// One generation of the 4-5 cave rule: a wall stays a wall with at least
+// four wall neighbours, and an open tile becomes a wall with at least five.
+// Tiles off the board count as walls, so `walls` should be built with
+// outside = true. The eight neighbour bits are summed with bit-parallel
+// carry-save adders, 64 tiles per word and four words per AVX2 register.
+// `next` must have the same size and outside value and is overwritten.
+void stepCaveAutomaton(const Bitboard& walls, Bitboard& next);
+
+}
+
+#endif
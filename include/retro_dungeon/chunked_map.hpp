@@ -0,0 +1,75 @@
+#ifndef RETRO_DUNGEON_CHUNKED_MAP_HPP
+#define RETRO_DUNGEON_CHUNKED_MAP_HPP
+
+#include "retro_dungeon/map.hpp"
+#include "retro_dungeon/types.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+namespace retro_dungeon {
+
+// Sparse map for very large worlds. Tiles are grouped into CHUNK_SIZE x
+// CHUNK_SIZE chunks that are only allocated once something other than a wall
+// is written into them; every untouched chunk reads from one shared all-wall
+// sentinel. Memory therefore grows with the carved area, not the bounds.
+// The tile API mirrors Map.
+class ChunkedMap {
+public:
+    static constexpr int CHUNK_SIZE = 32;
+
+    ChunkedMap(int w, int h);
+
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+
+    Tile getTile(int x, int y) const;
+    TileType getTileType(int x, int y) const;
+
+    bool isValidPosition(int x, int y) const;
+    bool isWalkable(int x, int y) const;
+    bool isExplored(int x, int y) const;
+
+    void setTile(int x, int y, TileType type);
+    void setExplored(int x, int y, bool explored);
+    void fillRect(int x, int y, int w, int h, TileType type);
+    void blit(const Map& map, int originX, int originY);
+
+    Position getStairsDown() const { return m_stairsDown; }
+    void setStairsDown(Position p) { m_stairsDown = p; }
+
+    std::size_t getChunkCount() const { return m_chunks.size(); }
+    std::size_t getMemoryUsage() const;
+
+    void clear();
+
+private:
+    struct Chunk {
+        std::array<TileType, CHUNK_SIZE * CHUNK_SIZE> types;
+        std::array<uint32_t, CHUNK_SIZE> walkable{};
+        std::array<uint32_t, CHUNK_SIZE> explored{};
+        int openTiles = 0;
+
+        Chunk() { types.fill(TileType::Wall); }
+        bool isBlank() const;
+    };
+
+    int m_width;
+    int m_height;
+    std::unordered_map<uint64_t, std::unique_ptr<Chunk>> m_chunks;
+    Position m_stairsDown;
+
+    static const Chunk& wallChunk();
+    static uint64_t chunkKey(int x, int y);
+
+    const Chunk& chunkAt(int x, int y) const;
+    Chunk* findChunk(int x, int y);
+    Chunk& chunkForWrite(int x, int y);
+    void releaseIfBlank(int x, int y, const Chunk& chunk);
+};
+
+}
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef RETRO_DUNGEON_CONNECTIVITY_HPP
+#define RETRO_DUNGEON_CONNECTIVITY_HPP
+
+#include "retro_dungeon/map.hpp"
+#include "retro_dungeon/types.hpp"
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace retro_dungeon {
+
+struct Component {
+    std::size_t size = 0;
+    int minX = INT_MAX;
+    int minY = INT_MAX;
+    int maxX = INT_MIN;
+    int maxY = INT_MIN;
+};
+
+// A horizontal run of walkable tiles [x0, x1) in row y.
+struct LabeledRun {
+    int32_t x0;
+    int32_t x1;
+    int32_t y;
+    int32_t label;
+};
+
+// Labels the 4-connected regions of walkable tiles with a two-pass
+// union-find over horizontal runs, read straight off the walkable bitplane.
+// Row strips are scanned in parallel, each uniting its runs with the
+// overlapping runs of the row above; the strips are then joined along their
+// border rows, and the second pass resolves every run to its component.
+// Unions keep the earlier run as root, so component ids follow the raster
+// order of each component's first tile and do not depend on the thread
+// count. Only runs are stored, never a per-tile label array.
+class ComponentLabels {
+public:
+    static constexpr int NONE = -1;
+
+    // threads <= 0 picks a count from the map size and the hardware.
+    void build(const Map& map, int threads = 0);
+
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+
+    // Binary search over the runs of row y; NONE for walls and off-map tiles.
+    int getLabel(int x, int y) const;
+    std::size_t getComponentCount() const { return m_components.size(); }
+    const Component& getComponent(int id) const { return m_components[id]; }
+    std::span<const Component> components() const { return m_components; }
+    std::span<const LabeledRun> runs() const { return m_runs; }
+
+    int getLargest() const;
+    bool isConnected(Position a, Position b) const;
+
+private:
+    int m_width = 0;
+    int m_height = 0;
+    std::vector<LabeledRun> m_runs;
+    std::vector<int32_t> m_rowStart;
+    std::vector<Component> m_components;
+};
+
+}
+
+#endif
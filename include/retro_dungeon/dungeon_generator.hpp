@@ -0,0 +1,107 @@
+#ifndef RETRO_DUNGEON_DUNGEON_GENERATOR_HPP
+#define RETRO_DUNGEON_DUNGEON_GENERATOR_HPP
+
+#include "retro_dungeon/map.hpp"
+#include "retro_dungeon/random.hpp"
+#include "retro_dungeon/types.hpp"
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace retro_dungeon {
+
+enum class DungeonStyle : uint8_t {
+    Rooms,
+    Caves
+};
+
+// Room-and-corridor levels from a binary space partition: the map is split
+// recursively until every leaf is at most MAX_LEAF_SIZE on a side, each leaf
+// gets one room, and sibling subtrees are joined by an L-shaped corridor, so
+// every room is reachable. Nodes live in one array reserved up front for the
+// worst case and reused across calls, and the work is linear in the map area.
+//
+// Cave levels start from noise on a Bitboard and run CAVE_SMOOTHING_STEPS
+// generations of the 4-5 cellular automaton (see cellular_automaton.hpp)
+// before being written into the Map a row at a time. Every cave except the
+// largest is then filled in, so cave levels are connected too.
+//
+// The random engine is a template parameter so hot paths can use a
+// small-state generator; DungeonGenerator below is the default choice.
+// Member definitions live in dungeon_generator.cpp, which instantiates the
+// engines listed at the bottom of this header.
+template <RandomEngine Engine>
+class BasicDungeonGenerator {
+public:
+    using engine_type = Engine;
+
+    static constexpr int MIN_LEAF_SIZE = 6;
+    static constexpr int MAX_LEAF_SIZE = 16;
+    static constexpr int MIN_ROOM_SIZE = 3;
+    static constexpr int CAVE_SMOOTHING_STEPS = 4;
+
+    BasicDungeonGenerator();
+    explicit BasicDungeonGenerator(uint64_t seed);
+
+    std::unique_ptr<Map> generate(int width, int height, DungeonStyle style = DungeonStyle::Rooms);
+    Engine& getRng() { return m_rng; }
+    uint64_t getSeed() const { return m_seed; }
+
+    // Bulk draws for noise fills and mass spawns. They come from a separate
+    // BatchRng stream, so mixing them with getRng() draws never reorders
+    // either sequence.
+    void fillInts(std::span<int> out, int lo, int hi) { m_batchRng.fillInts(out, lo, hi); }
+    void fillFloats(std::span<float> out) { m_batchRng.fillFloats(out); }
+    BatchRng& getBatchRng() { return m_batchRng; }
+
+    // Seed for a given dungeon level, derived only from the master seed so a
+    // level is identical no matter when or on which thread it is built.
+    static uint64_t levelSeed(uint64_t masterSeed, int level) {
+        return deriveSeed(masterSeed, level, RngStream::Generation);
+    }
+
+private:
+    struct Rect {
+        int x;
+        int y;
+        int width;
+        int height;
+    };
+
+    // Children of a split node are stored next to each other at firstChild
+    // and firstChild + 1, always after their parent. anchor is a point in
+    // some room of the subtree that corridors connect to.
+    struct Node {
+        Rect area;
+        Rect room;
+        int firstChild;
+        Position anchor;
+    };
+
+    uint64_t m_seed;
+    Engine m_rng;
+    BatchRng m_batchRng;
+    std::vector<Node> m_nodes;
+    std::vector<int> m_pending;
+
+    void generateRooms(Map& map);
+    void generateCorridors(Map& map);
+    void generateCaves(Map& map);
+    Position findValidPosition(const Map& map);
+
+    bool splitNode(int index);
+    void carveCorridor(Map& map, Position from, Position to);
+    Position randomPointIn(const Rect& rect);
+    const Node& leafAlong(int direction);
+};
+
+using DungeonGenerator = BasicDungeonGenerator<Xoshiro256StarStar>;
+
+extern template class BasicDungeonGenerator<Xoshiro256StarStar>;
+extern template class BasicDungeonGenerator<std::mt19937>;
+
+}
+
+#endif
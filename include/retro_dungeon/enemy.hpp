@@ -0,0 +1,173 @@
+#ifndef RETRO_DUNGEON_ENEMY_HPP
+#define RETRO_DUNGEON_ENEMY_HPP
+
+#include "retro_dungeon/types.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace retro_dungeon {
+
+constexpr std::size_t ENEMY_TYPE_COUNT = 7;
+
+struct EnemyStats {
+    HealthPoints health;
+    HealthPoints maxHealth;
+    DamagePoints attackPower;
+    DamagePoints defense;
+};
+
+// Everything that is fixed per EnemyType.
+struct EnemyArchetype {
+    std::string_view name;
+    char symbol;
+    EnemyStats stats;
+    int expReward;
+    int goldReward;
+};
+
+// Indexed by EnemyType; keep in enum order.
+inline constexpr std::array<EnemyArchetype, ENEMY_TYPE_COUNT> ENEMY_ARCHETYPES{{
+    {"Goblin", 'g', {20, 20, 5, 2}, 10, 5},
+    {"Orc", 'o', {40, 40, 10, 5}, 10, 5},
+    {"Skeleton", 's', {25, 25, 8, 3}, 10, 5},
+    {"Zombie", 'z', {35, 35, 6, 8}, 10, 5},
+    {"Dragon", 'D', {0, 200, 30, 20}, 10, 5},
+    {"Rat", 'r', {5, 5, 2, 0}, 10, 5},
+    {"Spider", 'x', {15, 15, 6, 1}, 10, 5},
+}};
+
+constexpr const EnemyArchetype& archetype(EnemyType type) {
+    return ENEMY_ARCHETYPES[static_cast<std::size_t>(type)];
+}
+
+// Stats grow with dungeon depth: health by 15% of the base per level below
+// the first, attack every second level and defense every third. Level 1 is
+// the archetype's base stats.
+constexpr EnemyStats scaleStats(const EnemyStats& base, int level) {
+    const int depth = level - 1;
+    return {base.health + base.health * 15 * depth / 100,
+            base.maxHealth + base.maxHealth * 15 * depth / 100,
+            base.attackPower + depth / 2, base.defense + depth / 3};
+}
+
+// scaleStats for every type and levels 1..MAX_SCALED_LEVEL, built at compile
+// time. Deeper levels use the last row.
+constexpr int MAX_SCALED_LEVEL = 32;
+
+inline constexpr auto ENEMY_STAT_CURVES = [] {
+    std::array<std::array<EnemyStats, ENEMY_TYPE_COUNT>, MAX_SCALED_LEVEL> curves{};
+    for (int level = 1; level <= MAX_SCALED_LEVEL; ++level) {
+        for (std::size_t type = 0; type < ENEMY_TYPE_COUNT; ++type) {
+            curves[level - 1][type] = scaleStats(ENEMY_ARCHETYPES[type].stats, level);
+        }
+    }
+    return curves;
+}();
+
+constexpr const EnemyStats& enemyStats(EnemyType type, int level = 1) {
+    const int row = level < 1 ? 0 : (level > MAX_SCALED_LEVEL ? MAX_SCALED_LEVEL : level) - 1;
+    return ENEMY_STAT_CURVES[row][static_cast<std::size_t>(type)];
+}
+
+// A single enemy by value: the type plus its mutable state. name and symbol
+// point into the archetype table, so constructing one never allocates.
+struct Enemy {
+    EntityId id;
+    std::string_view name;
+    EnemyType type;
+    Position pos;
+    char symbol;
+    int health;
+    int maxHealth;
+    int attackPower;
+    int defense;
+
+    Enemy(EntityId i, EnemyType t, Position p, int level = 1);
+
+    bool isAlive() const { return health > 0; }
+    void takeDamage(int dmg) { health -= dmg; }
+};
+
+// Recorded for every enemy removed by EnemyStore::removeDead. killer is the
+// last entity to damage it, or INVALID_ENTITY_ID.
+struct EnemyDeath {
+    EntityId id;
+    EnemyType type;
+    Position pos;
+    EntityId killer;
+};
+
+// Enemies stored as parallel component columns, one entry per live enemy,
+// so per-turn systems walk contiguous arrays instead of chasing pointers.
+// Entries are addressed by generational handles: the low 32 bits of an
+// EntityId pick a slot and the high 32 bits are that slot's generation,
+// which is bumped whenever the slot is freed. A handle to a destroyed enemy
+// therefore never resolves, even after its slot is reused. Generations
+// start at 1, so no handle equals INVALID_ENTITY_ID.
+//
+// destroy() swaps the last entry into the hole, so column order is not
+// stable across single removals; removeDead() compacts in place and keeps
+// the survivors in order.
+class EnemyStore {
+public:
+    static constexpr std::size_t NPOS = static_cast<std::size_t>(-1);
+
+    // Starts from enemyStats(type, level).
+    EntityId create(EnemyType type, Position pos, int level = 1);
+    void destroy(EntityId id);
+    void clear();
+
+    // Removes every enemy whose health is at or below zero in one pass,
+    // appending a record for each to `deaths`. Returns how many were removed.
+    std::size_t removeDead(std::vector<EnemyDeath>& deaths);
+
+    bool contains(EntityId id) const { return indexOf(id) != NPOS; }
+    // Column index of a live handle, or NPOS.
+    std::size_t indexOf(EntityId id) const;
+    std::size_t size() const { return m_ids.size(); }
+    bool empty() const { return m_ids.empty(); }
+
+    std::span<const EntityId> ids() const { return m_ids; }
+    std::span<const EnemyType> types() const { return m_types; }
+    std::span<Position> positions() { return m_positions; }
+    std::span<const Position> positions() const { return m_positions; }
+    std::span<HealthPoints> health() { return m_health; }
+    std::span<const HealthPoints> health() const { return m_health; }
+    std::span<const HealthPoints> maxHealth() const { return m_maxHealth; }
+    std::span<DamagePoints> attack() { return m_attack; }
+    std::span<const DamagePoints> attack() const { return m_attack; }
+    std::span<DamagePoints> defense() { return m_defense; }
+    std::span<const DamagePoints> defense() const { return m_defense; }
+    std::span<EntityId> lastAttacker() { return m_lastAttacker; }
+    std::span<const EntityId> lastAttacker() const { return m_lastAttacker; }
+
+private:
+    struct Slot {
+        uint32_t index;
+        uint32_t generation;
+    };
+
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_freeSlots;
+
+    std::vector<EntityId> m_ids;
+    std::vector<EnemyType> m_types;
+    std::vector<Position> m_positions;
+    std::vector<HealthPoints> m_health;
+    std::vector<HealthPoints> m_maxHealth;
+    std::vector<DamagePoints> m_attack;
+    std::vector<DamagePoints> m_defense;
+    std::vector<EntityId> m_lastAttacker;
+
+    void release(uint32_t slot);
+    void moveEntry(std::size_t from, std::size_t to);
+    void resizeColumns(std::size_t size);
+};
+
+}
+
+#endif
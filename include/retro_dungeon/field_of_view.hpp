@@ -0,0 +1,106 @@
+#ifndef RETRO_DUNGEON_FIELD_OF_VIEW_HPP
+#define RETRO_DUNGEON_FIELD_OF_VIEW_HPP
+
+#include "retro_dungeon/map.hpp"
+#include "retro_dungeon/types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace retro_dungeon {
+
+// Field of view by symmetric recursive shadowcasting (Albert Ford's
+// variant). Each quadrant is scanned row by row outward from the viewer,
+// narrowing the visible slope range at every wall and recursing at the
+// edge of each gap. A floor tile is shown only when its centre lies inside
+// the range, which makes sight symmetric: a sees b exactly when b sees a.
+// Walls in range are shown so the edges of rooms are drawn. Tiles that are
+// not walkable block sight.
+//
+// The scan reads the walkable plane directly and collects visible tiles in
+// a bitmap of the view's bounding box, which compute() then ORs into the
+// map's visible plane a row at a time, and from there into the explored
+// plane. Only the bounding box of the previous result is cleared, so the
+// cost follows the radius, not the map size.
+class FieldOfView {
+public:
+    // Tiles within `radius` (Euclidean) of `origin` that it can see.
+    void compute(Map& map, Position origin, int radius);
+    // The same view kept in this object only; the map's planes are left
+    // alone. Query it with sees().
+    void observe(const Map& map, Position origin, int radius);
+    // Whether the last compute or observe saw `p`.
+    bool sees(Position p) const;
+
+    // Box of the last result, clipped to the map; empty before the first.
+    int getBoundsX() const { return m_bounds.x; }
+    int getBoundsY() const { return m_bounds.y; }
+    int getBoundsWidth() const { return m_bounds.w; }
+    int getBoundsHeight() const { return m_bounds.h; }
+
+private:
+    struct Bounds {
+        int x = 0;
+        int y = 0;
+        int w = 0;
+        int h = 0;
+    };
+
+    // A slope as the fraction numerator / denominator, denominator > 0.
+    struct Slope {
+        int numerator;
+        int denominator;
+    };
+
+    const uint64_t* m_walkable = nullptr;
+    int m_stride = 0;
+    int m_width = 0;
+    int m_height = 0;
+    Position m_origin{0, 0};
+    int m_radius = 0;
+    // Widest column inside the disc at each depth.
+    std::vector<int> m_halfWidths;
+    // Octant pair being scanned: tile (col, depth) maps to
+    // origin + col * (m_colX, m_colY) + depth * (m_rowX, m_rowY).
+    int m_colX = 0;
+    int m_colY = 0;
+    int m_rowX = 0;
+    int m_rowY = 0;
+
+    Bounds m_bounds;
+    // Visible tiles of m_bounds, m_boxWords words per row.
+    std::vector<uint64_t> m_box;
+    int m_boxWords = 0;
+    // The map whose visible plane compute() last wrote, and where.
+    Map* m_written = nullptr;
+    Bounds m_writtenBounds;
+
+    void scan(int depth, Slope start, Slope end);
+    bool isOpaque(int x, int y) const;
+    void reveal(int x, int y);
+};
+
+// A monster's field of view, recomputed only when it can have changed: when
+// the observer moves or a tile inside its view box changes walkability.
+// Other writes to the map are filtered through its change journal.
+class ObserverView {
+public:
+    // Brings the view in line with an observer at `origin`. Returns true
+    // when it had to be recomputed.
+    bool update(const Map& map, Position origin, int radius);
+    bool sees(Position p) const { return m_fov.sees(p); }
+
+    std::size_t getRecomputeCount() const { return m_recomputes; }
+
+private:
+    FieldOfView m_fov;
+    const Map* m_map = nullptr;
+    Position m_origin = INVALID_POSITION;
+    int m_radius = -1;
+    uint64_t m_revision = 0;
+    std::size_t m_recomputes = 0;
+};
+
+}
+
+#endif
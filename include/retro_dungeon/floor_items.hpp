@@ -0,0 +1,88 @@
+#ifndef RETRO_DUNGEON_FLOOR_ITEMS_HPP
+#define RETRO_DUNGEON_FLOOR_ITEMS_HPP
+
+#include "retro_dungeon/item.hpp"
+#include "retro_dungeon/spatial_grid.hpp"
+#include "retro_dungeon/types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace retro_dungeon {
+
+// Items lying on the map, as one stack per tile. A SpatialGrid maps each
+// tile to the top node of its stack, and nodes link downwards through a
+// pooled node array, so dropping, picking up and "what is here" are O(1)
+// and radius queries only visit tiles that actually hold items.
+//
+// Node storage comes from the given memory resource (the level arena in
+// Game). reset() gives it back, so the resource may be rewound afterwards.
+class FloorItems {
+public:
+    explicit FloorItems(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    void reset(int width, int height);
+
+    // Puts the item on top of the tile's stack; false when off the grid.
+    bool drop(Position p, ItemHandle item);
+    // Top of the tile's stack, or INVALID_ITEM_HANDLE.
+    ItemHandle top(Position p) const;
+    // Removes and returns the top of the tile's stack.
+    ItemHandle pickUp(Position p);
+    // Removes the item from anywhere in the tile's stack.
+    bool remove(Position p, ItemHandle item);
+
+    std::size_t countAt(Position p) const;
+    std::size_t size() const { return m_size; }
+
+    // fn(item) for the tile's stack, top first.
+    template <typename Fn>
+    void forEachAt(Position p, Fn fn) const {
+        auto visit = [&](Position, ItemHandle item) { fn(item); };
+        walk(p, m_heads.at(p), visit);
+    }
+
+    // fn(position, item) for every item within `radius` tiles of center.
+    template <typename Fn>
+    void forEachInRadius(Position center, int radius, Fn fn) const {
+        m_heads.forEachInRadius(center, radius, [&](Position p, uint32_t head) { walk(p, head, fn); });
+    }
+
+    // fn(position, item) for every item, tile by tile in raster order.
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        m_heads.forEach([&](Position p, uint32_t head) { walk(p, head, fn); });
+    }
+
+    // fn(position, top item) for every non-empty tile in raster order.
+    template <typename Fn>
+    void forEachPile(Fn fn) const {
+        m_heads.forEach([&](Position p, uint32_t head) { fn(p, m_nodes[head - 1].item); });
+    }
+
+private:
+    struct Node {
+        ItemHandle item;
+        uint32_t next;
+    };
+
+    // Node index + 1 of each tile's top item; 0 for an empty tile.
+    SpatialGrid<uint32_t> m_heads;
+    std::pmr::vector<Node> m_nodes;
+    std::pmr::vector<uint32_t> m_freeNodes;
+    std::size_t m_size = 0;
+
+    void setHead(Position p, uint32_t node);
+
+    template <typename Fn>
+    void walk(Position p, uint32_t node, Fn& fn) const {
+        for (; node != 0; node = m_nodes[node - 1].next) {
+            fn(p, m_nodes[node - 1].item);
+        }
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef RETRO_DUNGEON_FLOW_FIELD_HPP
+#define RETRO_DUNGEON_FLOW_FIELD_HPP
+
+#include "retro_dungeon/map.hpp"
+#include "retro_dungeon/types.hpp"
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace retro_dungeon {
+
+// A distance map ("Dijkstra map") over a Map's walkable tiles: the number
+// of 4-connected steps from each tile to the nearest source. Any number of
+// movers share one field and each steps downhill by looking at its four
+// neighbours, instead of running a search per mover.
+//
+// Fields are filled with a bucket queue keyed by value, so sources and
+// seeds may start at any integer. Values are stored per tile in the map's
+// y * stride + x order, plus a field-wide offset that lets follow() move a
+// single source one step without touching most of the map.
+class FlowField {
+public:
+    static constexpr int UNREACHABLE = INT_MAX;
+    // Brogue's choice: far enough above -1 that fleeing movers prefer
+    // distant escape routes over corners near the threat.
+    static constexpr double FLEE_COEFFICIENT = -1.2;
+
+    // Distances from the nearest of `sources`. Sources need not be walkable;
+    // every step out of one must be.
+    void compute(const Map& map, std::span<const Position> sources);
+
+    // compute() from the single source `target`, updated in place when the
+    // field was last built on this map, unchanged since, from a single
+    // source one step away from `target`. On a 4-connected grid every
+    // distance then changes by exactly one: tiles reached through `target`
+    // come one step closer and only those are visited.
+    void follow(const Map& map, Position target);
+
+    // A field that leads away from the sources of `toward`, another field
+    // built on the same map: each distance times `coefficient`, then relaxed
+    // so no tile is more than one above a neighbour. Movers stepping downhill retreat
+    // and will run past the threat to reach a distant open area rather than
+    // cower in a dead end.
+    void computeFlee(const Map& map, const FlowField& toward, double coefficient = FLEE_COEFFICIENT);
+
+    // UNREACHABLE for walls, off-map and unreached tiles.
+    int valueAt(Position p) const;
+    // The neighbour of `p` with the lowest value below p's own (first in
+    // Direction order on ties), or `p` when there is none.
+    Position downhill(Position p) const;
+
+    std::size_t getRebuildCount() const { return m_rebuilds; }
+    std::size_t getFollowCount() const { return m_follows; }
+
+private:
+    struct Entry {
+        uint32_t cell;
+        uint32_t next;
+    };
+
+    int m_width = 0;
+    int m_height = 0;
+    int m_stride = 0;
+    const uint64_t* m_walkable = nullptr;
+    std::vector<int> m_values;
+    int m_offset = 0;
+
+    // What follow() needs to know to update in place.
+    const Map* m_map = nullptr;
+    uint64_t m_revision = 0;
+    Position m_source = INVALID_POSITION;
+
+    // Bucket queue: m_heads[v - m_base] lists the cells queued at value v.
+    int m_base = 0;
+    std::vector<uint32_t> m_heads;
+    std::vector<Entry> m_entries;
+    uint32_t m_freeEntry = 0;
+    std::vector<uint32_t> m_stack;
+
+    std::size_t m_rebuilds = 0;
+    std::size_t m_follows = 0;
+
+    bool isOpen(int x, int y) const {
+        if (static_cast<unsigned>(x) >= static_cast<unsigned>(m_width) ||
+            static_cast<unsigned>(y) >= static_cast<unsigned>(m_height)) {
+            return false;
+        }
+        const auto cell = static_cast<uint32_t>(y * m_stride + x);
+        return ((m_walkable[cell >> 6] >> (cell & 63)) & 1) != 0;
+    }
+
+    void reset(const Map& map, int base);
+    void push(uint32_t cell, int value);
+    void propagate();
+};
+
+}
+
+#endif
@@ -2,55 +2,28 @@
 #define RETRO_DUNGEON_GAME_HPP
 
 #include "retro_dungeon/types.hpp"
+#include "retro_dungeon/map.hpp"
+#include "retro_dungeon/dungeon_generator.hpp"
+#include "retro_dungeon/enemy.hpp"
+#include "retro_dungeon/field_of_view.hpp"
+#include "retro_dungeon/floor_items.hpp"
+#include "retro_dungeon/flow_field.hpp"
+#include "retro_dungeon/item.hpp"
+#include "retro_dungeon/level_arena.hpp"
+#include "retro_dungeon/level_pipeline.hpp"
+#include "retro_dungeon/line_of_sight.hpp"
+#include "retro_dungeon/random.hpp"
+#include "retro_dungeon/spawn_sampler.hpp"
+#include "retro_dungeon/spatial_grid.hpp"
 #include <vector>
 #include <memory>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <random>
 
 namespace retro_dungeon {
 
-struct Tile {
-    TileType type = TileType::Wall;
-    char symbol = '#';
-    bool walkable = false;
-    bool explored = false;
-    bool visible = false;
-    
-    Tile() = default;
-    Tile(TileType t, char s, bool w) : type(t), symbol(s), walkable(w) {}
-};
-
-struct Item {
-    std::string name;
-    ItemType type;
-    char symbol;
-    int value;
-    int damage;
-    int healAmount;
-    
-    Item(std::string n, ItemType t, char s, int v, int d = 0, int h = 0)
-        : name(std::move(n)), type(t), symbol(s), value(v), damage(d), healAmount(h) {}
-};
-
-struct Enemy {
-    EntityId id;
-    std::string name;
-    EnemyType type;
-    Position pos;
-    char symbol;
-    int health;
-    int maxHealth;
-    int attackPower;
-    int defense;
-    int expReward;
-    int goldReward;
-    
-    Enemy(EntityId i, EnemyType t, Position p);
-    
-    bool isAlive() const { return health > 0; }
-    void takeDamage(int dmg) { health -= dmg; }
-};
-
 struct Player {
     EntityId id;
     std::string name;
@@ -63,61 +36,17 @@ struct Player {
     int experience;
     int gold;
     int dungeonLevel;
-    std::vector<std::shared_ptr<Item>> inventory;
+    Inventory inventory;
     
     Player(EntityId i, std::string n, Position p);
     
     bool isAlive() const { return health > 0; }
     void takeDamage(int dmg) { health -= dmg; }
     void heal(int amt);
-    bool addItem(std::shared_ptr<Item> item);
+    bool addItem(ItemHandle item);
     bool move(Direction dir);
 };
 
-class Map {
-public:
-    Map(int w, int h);
-    
-    int getWidth() const { return m_width; }
-    int getHeight() const { return m_height; }
-    
-    Tile& getTile(int x, int y);
-    const Tile& getTile(int x, int y) const;
-    
-    bool isValidPosition(int x, int y) const;
-    bool isWalkable(int x, int y) const;
-    
-    void setTile(int x, int y, TileType type);
-    
-    Position getStairsDown() const { return m_stairsDown; }
-    void setStairsDown(Position p) { m_stairsDown = p; }
-    
-    void clear();
-    
-private:
-    int m_width;
-    int m_height;
-    std::vector<std::vector<Tile>> m_tiles;
-    Position m_stairsDown;
-};
-
-class DungeonGenerator {
-public:
-    DungeonGenerator();
-    explicit DungeonGenerator(unsigned int seed);
-    
-    std::unique_ptr<Map> generate(int width, int height);
-    std::mt19937& getRng() { return m_rng; }
-    
-private:
-    unsigned int m_seed;
-    std::mt19937 m_rng;
-    
-    void generateRooms(Map& map);
-    void generateCorridors(Map& map);
-    Position findValidPosition(const Map& map);
-};
-
 class Game {
 public:
     Game();
@@ -130,6 +59,7 @@ public:
     GameState getState() const { return m_state; }
     Player* getPlayer() { return m_player.get(); }
     Map* getMap() { return m_map.get(); }
+    ItemStore& getItems() { return m_items; }
     
     void newGame(const std::string& playerName);
     bool saveGame(const std::string& filename);
@@ -139,11 +69,11 @@ public:
     void update();
     void render();
     
-    void addMessage(const std::string& msg);
+    void addMessage(std::string_view msg);
     const std::vector<std::string>& getMessages() const { return m_messages; }
     
     void handleMovement(Direction dir);
-    void handleCombat(Enemy& enemy);
+    void handleCombat(EntityId enemy);
     void nextLevel();
     
 private:
@@ -151,15 +81,38 @@ private:
     std::unique_ptr<Player> m_player;
     std::unique_ptr<Map> m_map;
     std::unique_ptr<DungeonGenerator> m_generator;
-    std::vector<std::unique_ptr<Enemy>> m_enemies;
-    std::vector<std::shared_ptr<Item>> m_floorItems;
+    std::unique_ptr<LevelPipeline> m_levels;
+    LevelArena m_arena;
+    SplitMix64 m_spawnRng;
+    SplitMix64 m_itemRng;
+    EnemyStore m_enemies;
+    SpatialGrid<EntityId> m_enemyGrid;
+    std::vector<EnemyDeath> m_deaths;
+    ItemStore m_items;
+    ItemDefId m_healthPotion;
+    FloorItems m_floorItems;
+    SpawnSampler m_spawns;
+    FlowField m_chaseField;
+    FlowField m_fleeField;
+    FieldOfView m_fov;
+    LineOfSight m_sight;
+    std::vector<uint8_t> m_enemySight;
     std::vector<std::string> m_messages;
+    std::string m_messageScratch;
     EntityId m_nextEntityId;
     
+    void seedLevelStreams(int level);
+    void resetLevel();
+    void clearFloorItems();
+    Position randomWalkableTile(SplitMix64& rng) const;
+    void pickUpItems();
     void spawnEnemies(int count);
     void spawnItems(int count);
     void removeDeadEnemies();
-    Enemy* getEnemyAt(Position pos);
+    void moveEnemies();
+    template <typename... Parts>
+    void logMessage(const Parts&... parts);
+    EntityId getEnemyAt(Position pos) const;
     
     void renderMap();
     void renderEntities();
@@ -167,8 +120,12 @@ private:
     void renderMessages();
     
     static constexpr int MAX_MESSAGES = 5;
+    static constexpr std::size_t MESSAGE_CAPACITY = 80;
     static constexpr int MAP_WIDTH = 60;
     static constexpr int MAP_HEIGHT = 20;
+    static constexpr int CHASE_RADIUS = 8;
+    static constexpr int FLEE_HEALTH_PERCENT = 25;
+    static constexpr int FOV_RADIUS = 8;
 };
 
 }
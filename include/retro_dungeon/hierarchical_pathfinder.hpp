@@ -0,0 +1,173 @@
+#ifndef RETRO_DUNGEON_HIERARCHICAL_PATHFINDER_HPP
+#define RETRO_DUNGEON_HIERARCHICAL_PATHFINDER_HPP
+
+#include "retro_dungeon/map.hpp"
+#include "retro_dungeon/types.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace retro_dungeon {
+
+// HPA*: 4-connected paths over a coarse graph instead of every tile.
+//
+// The map is cut into square clusters. Wherever open tiles face each other
+// across the border between two clusters, each maximal run of them gets an
+// entrance: one tile pair in the middle of a short run, one at each end of
+// a run of ENTRANCE_SPLIT_LENGTH or more. Both tiles of a pair are abstract
+// nodes, joined by a one-step edge, and nodes in the same cluster are
+// joined by their exact distance inside it. An intra-cluster edge is
+// dropped when another node lies on a shortest path between its ends, so
+// open clusters keep a handful of edges per node without changing any
+// distance in the graph. A query links start
+// and goal into this graph, runs A* over it and returns the entrance tiles
+// the path crosses; refine() turns one stretch between them into tiles
+// when the mover actually walks it.
+//
+// Paths stay inside clusters between entrances, so they can be a little
+// longer than the true shortest path. The graph follows the map's change
+// journal: a tile change rebuilds its own cluster, plus the neighbour when
+// the tile lies on their shared border.
+class HierarchicalPathfinder {
+public:
+    static constexpr int DEFAULT_CLUSTER_SIZE = 64;
+    // A cluster row must fit one word of the walkable plane.
+    static constexpr int MAX_CLUSTER_SIZE = 64;
+    static constexpr int ENTRANCE_SPLIT_LENGTH = 6;
+
+    explicit HierarchicalPathfinder(int clusterSize = DEFAULT_CLUSTER_SIZE);
+
+    int getClusterSize() const { return m_clusterSize; }
+
+    // Brings the graph in line with `map`. findPath and refine do this
+    // themselves.
+    void sync(const Map& map);
+
+    // On success `waypoints` holds the entrance tiles the path crosses and
+    // then goal; getPathLength() is the number of steps once refined.
+    // Returns false, with `waypoints` empty, when goal is unreachable.
+    bool findPath(const Map& map, Position start, Position goal, std::vector<Position>& waypoints);
+
+    // The tiles after `from` up to and including `to`, for consecutive
+    // points of a path from findPath (start counts as the point before the
+    // first waypoint). False when the two are not in one cluster or
+    // adjacent, or not connected.
+    bool refine(const Map& map, Position from, Position to, std::vector<Position>& steps);
+
+    int getPathLength() const { return m_pathLength; }
+    // Abstract nodes expanded by the last findPath.
+    std::size_t getExpandedCount() const { return m_expanded; }
+    std::size_t getNodeCount() const { return m_nodeCluster.size(); }
+    std::size_t getClusterCount() const { return m_clusters.size(); }
+    std::size_t getRebuildCount() const { return m_rebuilds; }
+    std::size_t getClusterRebuildCount() const { return m_clusterRebuilds; }
+
+private:
+    enum Border { NORTH, SOUTH, EAST, WEST, BORDER_COUNT };
+
+    struct Edge {
+        uint32_t to;  // local index in the same cluster
+        uint32_t cost;
+    };
+
+    struct Cluster {
+        int x;
+        int y;
+        int width;
+        int height;
+        // Nodes on border b are nodes[borderStart[b], borderStart[b + 1]).
+        std::array<uint32_t, BORDER_COUNT + 1> borderStart;
+        std::vector<Position> nodes;
+        // Edges out of node i are edges[edgeStart[i], edgeStart[i + 1]).
+        std::vector<uint32_t> edgeStart;
+        std::vector<Edge> edges;
+    };
+
+    struct SearchNode {
+        uint32_t stamp;
+        uint32_t g;
+        uint32_t parent;
+    };
+
+    struct OpenEntry {
+        uint32_t g;
+        uint32_t node;
+        uint32_t next;
+    };
+
+    int m_clusterSize;
+    int m_columns = 0;
+    int m_rows = 0;
+
+    const Map* m_map = nullptr;
+    uint64_t m_revision = 0;
+    int m_width = 0;
+    int m_height = 0;
+    int m_stride = 0;
+    const uint64_t* m_walkable = nullptr;
+
+    std::vector<Cluster> m_clusters;
+    // Entrance offsets along each border. Vertical border i separates
+    // cluster i from its east neighbour, horizontal border i cluster i from
+    // its south neighbour.
+    std::vector<std::vector<uint16_t>> m_verticalBorders;
+    std::vector<std::vector<uint16_t>> m_horizontalBorders;
+    std::vector<uint8_t> m_dirtyClusters;
+    std::vector<uint8_t> m_dirtyVertical;
+    std::vector<uint8_t> m_dirtyHorizontal;
+    // Global node ids: cluster c owns [m_nodeBase[c], m_nodeBase[c + 1]).
+    std::vector<uint32_t> m_nodeBase;
+    std::vector<uint32_t> m_nodeCluster;
+    std::vector<Position> m_nodePositions;
+
+    std::vector<SearchNode> m_search;
+    // Open list: m_heads[f - manhattan(start, goal)] chains m_open entries.
+    std::vector<uint32_t> m_heads;
+    std::vector<OpenEntry> m_open;
+    uint32_t m_generation = 0;
+    std::vector<uint32_t> m_local;
+    // flood() state, one word per cluster row.
+    std::vector<uint64_t> m_rowOpen;
+    std::vector<uint64_t> m_reached;
+    std::vector<uint64_t> m_frontier;
+    std::vector<uint64_t> m_next;
+    std::vector<uint32_t> m_goalDistances;
+    // In-cluster distance between nodes i and j at [i * k + j] while a
+    // cluster is built.
+    std::vector<uint32_t> m_distances;
+
+    int m_pathLength = -1;
+    std::size_t m_expanded = 0;
+    std::size_t m_rebuilds = 0;
+    std::size_t m_clusterRebuilds = 0;
+
+    bool isOpen(int x, int y) const {
+        if (static_cast<unsigned>(x) >= static_cast<unsigned>(m_width) ||
+            static_cast<unsigned>(y) >= static_cast<unsigned>(m_height)) {
+            return false;
+        }
+        const auto cell = static_cast<uint32_t>(y * m_stride + x);
+        return ((m_walkable[cell >> 6] >> (cell & 63)) & 1) != 0;
+    }
+    int clusterOf(Position p) const {
+        return (p.second / m_clusterSize) * m_columns + p.first / m_clusterSize;
+    }
+
+    void rebuild();
+    void markChanged(Position p);
+    void buildBorder(int cluster, bool vertical);
+    void buildCluster(int cluster);
+    void numberNodes();
+    const std::vector<uint16_t>* entrancesOn(int cluster, int border) const;
+    Position borderTile(int cluster, int border, uint16_t offset) const;
+    uint32_t partnerOf(int cluster, uint32_t local) const;
+    // Breadth-first distances from `source` to every tile of the cluster,
+    // into m_local (cluster-relative, row-major).
+    void flood(const Cluster& cluster, Position source);
+    uint32_t localDistance(const Cluster& cluster, Position p) const;
+};
+
+}
+
+#endif
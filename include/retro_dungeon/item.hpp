@@ -0,0 +1,100 @@
+#ifndef RETRO_DUNGEON_ITEM_HPP
+#define RETRO_DUNGEON_ITEM_HPP
+
+#include "retro_dungeon/types.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace retro_dungeon {
+
+// Shared description of a kind of item. Every instance of it refers back
+// here instead of carrying its own copy.
+struct ItemDef {
+    std::string_view name;
+    ItemType type;
+    char symbol;
+    int value;
+    int damage = 0;
+    int healAmount = 0;
+};
+
+using ItemDefId = uint32_t;
+
+// Generational reference to an item instance in an ItemStore. Generation 0
+// is never handed out, so a default-constructed handle is always invalid.
+struct ItemHandle {
+    uint32_t index = 0;
+    uint32_t generation = 0;
+
+    bool isValid() const { return generation != 0; }
+    friend bool operator==(ItemHandle, ItemHandle) = default;
+};
+
+constexpr ItemHandle INVALID_ITEM_HANDLE{};
+
+// Item instances in a slot map. Definitions are interned by name: defining
+// an existing name returns the existing id, and the store owns the
+// characters every ItemDef::name views. Instances are just a definition id
+// per slot; destroying one bumps the slot's generation so older handles stop
+// resolving, and the slot is reused by the next create().
+class ItemStore {
+public:
+    ItemDefId define(const ItemDef& def);
+    const ItemDef& getDef(ItemDefId id) const { return m_defs[id]; }
+    std::size_t getDefCount() const { return m_defs.size(); }
+
+    ItemHandle create(ItemDefId def);
+    void destroy(ItemHandle handle);
+
+    bool contains(ItemHandle handle) const;
+    // nullptr for stale handles.
+    const ItemDef* get(ItemHandle handle) const;
+    std::size_t size() const { return m_size; }
+
+private:
+    struct Slot {
+        ItemDefId def;
+        uint32_t generation;
+    };
+
+    std::deque<std::string> m_names;
+    std::vector<ItemDef> m_defs;
+    std::unordered_map<std::string_view, ItemDefId> m_defsByName;
+
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_freeSlots;
+    std::size_t m_size = 0;
+};
+
+// Fixed-capacity list of item handles held inline, in pickup order.
+class Inventory {
+public:
+    static constexpr std::size_t CAPACITY = 20;
+
+    // False when the inventory is full.
+    bool add(ItemHandle item);
+    // Removes the item at `slot`, keeping the others in order.
+    ItemHandle removeAt(std::size_t slot);
+    void clear() { m_count = 0; }
+
+    std::size_t size() const { return m_count; }
+    bool empty() const { return m_count == 0; }
+    bool full() const { return m_count == CAPACITY; }
+    ItemHandle operator[](std::size_t slot) const { return m_items[slot]; }
+    const ItemHandle* begin() const { return m_items.data(); }
+    const ItemHandle* end() const { return m_items.data() + m_count; }
+
+private:
+    std::array<ItemHandle, CAPACITY> m_items{};
+    std::size_t m_count = 0;
+};
+
+}
+
+#endif
@@ -0,0 +1,123 @@
+#ifndef RETRO_DUNGEON_JUMP_POINT_SEARCH_HPP
+#define RETRO_DUNGEON_JUMP_POINT_SEARCH_HPP
+
+#include "retro_dungeon/map.hpp"
+#include "retro_dungeon/types.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace retro_dungeon {
+
+// Jump Point Search for 4-connected, uniform-cost movement, with the jump
+// distances precomputed per tile and direction (JPS+).
+//
+// Among equally short paths only those that turn from a horizontal run into
+// a vertical one where a wall forces it are searched: moving east or west,
+// a tile is a jump point when the tile above or below it is open but the
+// one diagonally behind is not. A vertical run stops at any tile from which
+// a horizontal run reaches a jump point, and at the goal's row. Only jump
+// points enter the open list, so open corridors and rooms cost a handful of
+// expansions instead of one per tile.
+//
+// The tables are derived from the map's walkable plane and follow its
+// change journal: after setTile only the rows around a changed tile, and
+// the column stretches crossing tiles whose horizontal jumps changed, are
+// recomputed. A different map, a
+// bulk write or more changes than the journal holds rebuild everything.
+// Path costs use Pathfinder::STRAIGHT_COST per step, so they compare
+// directly with Pathfinder's.
+class JumpPointSearch {
+public:
+    // Jump distances are stored as int16_t, so wider or taller maps are
+    // refused.
+    static constexpr int MAX_SIDE = INT16_MAX;
+
+    // Brings the jump tables in line with `map`. findPath does this itself.
+    // Returns false, leaving no tables, when a side exceeds MAX_SIDE.
+    bool sync(const Map& map);
+
+    // Same contract as Pathfinder::findPath with Movement::Cardinal;
+    // maxExpansions counts expanded jump points. Always fails on maps that
+    // sync refuses.
+    bool findPath(const Map& map, Position start, Position goal, std::vector<Position>& path,
+                  std::size_t maxExpansions = 0);
+
+    // Steps from (x, y) towards `dir` to the next jump point when positive;
+    // otherwise minus the number of open steps before a wall. Valid after
+    // sync for walkable tiles.
+    int jumpDistance(int x, int y, Direction dir) const;
+
+    std::size_t getExpandedCount() const { return m_expanded; }
+    int getPathCost() const { return m_pathCost; }
+    // Full table builds, and tiles patched in from the change journal.
+    std::size_t getRebuildCount() const { return m_rebuilds; }
+    std::size_t getPatchedTileCount() const { return m_patchedTiles; }
+
+private:
+    using Jumps = std::array<int16_t, 4>;
+
+    struct Node {
+        uint32_t stamp;
+        uint32_t g;
+        uint32_t parent;
+        // Directions the node has been reached from at cost g, as bits.
+        uint8_t arrivals;
+    };
+
+    struct OpenEntry {
+        uint32_t f;
+        uint32_t g;
+        uint32_t cell;
+        uint8_t arrival;
+    };
+
+    const Map* m_map = nullptr;
+    uint64_t m_revision = 0;
+    int m_width = 0;
+    int m_height = 0;
+    int m_stride = 0;
+    const uint64_t* m_walkable = nullptr;
+    std::vector<Jumps> m_jumps;
+
+    std::vector<uint8_t> m_dirtyRows;
+    // Per column, the rows whose vertical runs must be redone; empty when
+    // top > bottom.
+    std::vector<int> m_columnTop;
+    std::vector<int> m_columnBottom;
+    std::vector<uint8_t> m_rowJumps;
+
+    std::vector<Node> m_nodes;
+    std::vector<OpenEntry> m_open;
+    uint32_t m_generation = 0;
+    std::size_t m_expanded = 0;
+    int m_pathCost = -1;
+    std::size_t m_rebuilds = 0;
+    std::size_t m_patchedTiles = 0;
+
+    uint32_t cellOf(int x, int y) const { return static_cast<uint32_t>(y * m_stride + x); }
+    bool isOpen(int x, int y) const {
+        if (static_cast<unsigned>(x) >= static_cast<unsigned>(m_width) ||
+            static_cast<unsigned>(y) >= static_cast<unsigned>(m_height)) {
+            return false;
+        }
+        const uint32_t cell = cellOf(x, y);
+        return ((m_walkable[cell >> 6] >> (cell & 63)) & 1) != 0;
+    }
+    bool hasHorizontalJump(uint32_t cell) const;
+
+    void rebuild();
+    void patch();
+    void buildRow(int y);
+    void markColumn(int x, int y);
+    void buildColumn(int x, int y0, int y1);
+    void buildVertical(int x, int y, Direction dir);
+
+    void relax(uint32_t cell, uint32_t g, uint32_t parent, uint8_t arrival, Position goal);
+    void buildPath(Position goal, std::vector<Position>& path) const;
+};
+
+}
+
+#endif
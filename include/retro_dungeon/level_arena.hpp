@@ -0,0 +1,78 @@
+#ifndef RETRO_DUNGEON_LEVEL_ARENA_HPP
+#define RETRO_DUNGEON_LEVEL_ARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+namespace retro_dungeon {
+
+// Bump allocator for everything that lives exactly as long as one level.
+// Allocations are carved out of a block reserved up front; deallocation is a
+// no-op and reset() rewinds the whole arena in O(1). When a level outgrows
+// the block, the overflow comes from the general heap and is counted, so
+// getUpstreamAllocationCount() staying flat means play is not touching the
+// heap through the arena. The overflow resource can be swapped out, e.g. to
+// observe it from tests.
+//
+// reset() does not run destructors: owners destroy non-trivial objects
+// before rewinding.
+class LevelArena : public std::pmr::memory_resource {
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY = std::size_t{64} << 10;
+
+    explicit LevelArena(std::size_t capacity = DEFAULT_CAPACITY,
+                        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    LevelArena(const LevelArena&) = delete;
+    LevelArena& operator=(const LevelArena&) = delete;
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        return std::pmr::polymorphic_allocator<>(this).new_object<T>(std::forward<Args>(args)...);
+    }
+
+    void reset();
+
+    std::size_t getCapacity() const { return m_capacity; }
+    // Since the last reset().
+    std::size_t getAllocationCount() const { return m_allocations; }
+    std::size_t getBytesAllocated() const { return m_bytes; }
+    // Over the arena's lifetime.
+    std::size_t getResetCount() const { return m_resets; }
+    std::size_t getUpstreamAllocationCount() const { return m_upstream.allocations; }
+    std::size_t getUpstreamBytes() const { return m_upstream.bytes; }
+
+private:
+    struct CountingResource : std::pmr::memory_resource {
+        explicit CountingResource(std::pmr::memory_resource* resource) : upstream(resource) {}
+
+        std::pmr::memory_resource* upstream;
+        std::size_t allocations = 0;
+        std::size_t bytes = 0;
+
+        void* do_allocate(std::size_t size, std::size_t alignment) override;
+        void do_deallocate(void* p, std::size_t size, std::size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    std::size_t m_capacity;
+    std::unique_ptr<std::byte[]> m_block;
+    CountingResource m_upstream;
+    std::pmr::monotonic_buffer_resource m_resource;
+    std::size_t m_allocations = 0;
+    std::size_t m_bytes = 0;
+    std::size_t m_resets = 0;
+
+    void* do_allocate(std::size_t size, std::size_t alignment) override;
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+}
+
+#endif
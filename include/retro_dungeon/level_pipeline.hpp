@@ -0,0 +1,66 @@
+#ifndef RETRO_DUNGEON_LEVEL_PIPELINE_HPP
+#define RETRO_DUNGEON_LEVEL_PIPELINE_HPP
+
+#include "retro_dungeon/map.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace retro_dungeon {
+
+// Speculatively generates the levels below the current one on a small worker
+// pool. Every level is built from DungeonGenerator::levelSeed(masterSeed,
+// level), so a pre-generated map is identical to one built on demand.
+//
+// Finished maps are handed over through a ring of `lookahead` slots, one per
+// upcoming level, guarded only by atomics: neither side ever takes a lock.
+// acquire() falls back to building the level itself when its slot is not
+// ready yet.
+class LevelPipeline {
+public:
+    LevelPipeline(uint64_t masterSeed, int width, int height, int lookahead = 2,
+                  int workers = 0);
+    LevelPipeline(const LevelPipeline&) = delete;
+    LevelPipeline& operator=(const LevelPipeline&) = delete;
+    ~LevelPipeline();
+
+    std::unique_ptr<Map> acquire(int level);
+    std::unique_ptr<Map> generateLevel(int level) const;
+
+    bool isReady(int level) const;
+    int getHitCount() const { return m_hits; }
+    int getMissCount() const { return m_misses; }
+
+private:
+    enum SlotState : int { Empty, Busy, Ready };
+
+    struct Slot {
+        std::atomic<int> state{Empty};
+        std::atomic<int> level{0};
+        std::unique_ptr<Map> map;
+    };
+
+    uint64_t m_masterSeed;
+    int m_width;
+    int m_height;
+    int m_lookahead;
+    std::unique_ptr<Slot[]> m_slots;
+    std::atomic<int> m_current{0};
+    std::atomic<int> m_nextLevel{1};
+    std::atomic<int> m_horizon{0};
+    std::atomic<bool> m_stopping{false};
+    int m_hits = 0;
+    int m_misses = 0;
+    std::vector<std::jthread> m_workers;
+
+    Slot& slotFor(int level) const { return m_slots[level % m_lookahead]; }
+    bool lockSlot(Slot& slot, int expected) const;
+    void deposit(int level, std::unique_ptr<Map> map);
+    void workerLoop();
+};
+
+}
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef RETRO_DUNGEON_LINE_OF_SIGHT_HPP
+#define RETRO_DUNGEON_LINE_OF_SIGHT_HPP
+
+#include "retro_dungeon/map.hpp"
+#include "retro_dungeon/types.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace retro_dungeon {
+
+// Line-of-sight tests for many observer/target pairs at once.
+//
+// An observer sees a target when every tile strictly between them on the
+// Bresenham line from observer to target is walkable. For pairs no more
+// than RANGE apart on either axis the line is not walked at all: the walls
+// around the target are packed into a window of 32 rows of 32 bits, and a
+// table built once holds, for every observer offset, the same window with
+// the line's tiles set. The pair is clear when the two share no bit, which
+// is a 128-byte AND and zero test: four AVX2 or eight SSE2 operations.
+// Consecutive pairs with the same target share one window, and the window
+// is kept between calls until the target moves or the map's walkable
+// plane changes. Farther pairs walk their line tile by tile.
+class LineOfSight {
+public:
+    static constexpr int RANGE = 15;
+
+    LineOfSight();
+
+    bool canSee(const Map& map, Position observer, Position target);
+
+    // results[i] is 1 when observers[i] sees targets[i], else 0. The three
+    // spans must have the same length.
+    void canSee(const Map& map, std::span<const Position> observers, std::span<const Position> targets,
+                std::span<uint8_t> results);
+
+    // The same for every observer against one target.
+    void canSee(const Map& map, std::span<const Position> observers, Position target,
+                std::span<uint8_t> results);
+
+    std::size_t getWindowBuildCount() const { return m_windowBuilds; }
+
+private:
+    static constexpr int WINDOW_SIZE = 2 * RANGE + 1;
+    static constexpr int WINDOW_WORDS = 16;
+    static_assert(WINDOW_SIZE <= 32, "window rows are 32 bits");
+
+    // Row r of the window is bits [32 * (r & 1), 32 * (r & 1) + 32) of word
+    // r / 2. Bit c of a row is the tile c - RANGE columns from the centre,
+    // row r the one r - RANGE rows from it.
+    struct alignas(32) Window {
+        std::array<uint64_t, WINDOW_WORDS> words;
+    };
+
+    std::vector<Window> m_rays;
+    Window m_walls{};
+    const Map* m_map = nullptr;
+    uint64_t m_revision = 0;
+    Position m_center = INVALID_POSITION;
+    std::size_t m_windowBuilds = 0;
+
+    bool test(const Map& map, Position observer, Position target);
+    void buildWindow(const Map& map, Position center);
+};
+
+}
+
+#endif
@@ -0,0 +1,210 @@
+#ifndef RETRO_DUNGEON_MAP_HPP
+#define RETRO_DUNGEON_MAP_HPP
+
+#include "retro_dungeon/types.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace retro_dungeon {
+
+class MappedFile;
+
+struct Tile {
+    TileType type = TileType::Wall;
+    char symbol = '#';
+    bool walkable = false;
+    bool explored = false;
+    bool visible = false;
+
+    Tile() = default;
+    Tile(TileType t, char s, bool w) : type(t), symbol(s), walkable(w) {}
+};
+
+struct TileTraits {
+    char symbol;
+    bool walkable;
+};
+
+// Indexed by TileType; keep in enum order.
+inline constexpr std::array<TileTraits, 6> TILE_TRAITS{{
+    {'.', true},
+    {'#', false},
+    {'+', true},
+    {'<', true},
+    {'>', true},
+    {'^', true},
+}};
+
+// Out-of-range values, which a map file can carry since its tiles are not
+// checked on load, read as walls.
+constexpr const TileTraits& tileTraits(TileType type) {
+    const auto index = static_cast<std::size_t>(type);
+    constexpr auto WALL = static_cast<std::size_t>(TileType::Wall);
+    return TILE_TRAITS[index < TILE_TRAITS.size() ? index : WALL];
+}
+
+// Tile types are stored one byte per tile in a row-major buffer. Walkable,
+// explored and visible are kept as bitplanes of 64-bit words, one bit per
+// tile, so whole-map queries run a word at a time. Rows are padded to a
+// multiple of 64 tiles so every row starts on a word boundary; padding tiles
+// are walls and never have a bit set.
+//
+// The type layer and walkable plane are either owned by the map or live in a
+// private mapping of a map file (see map_file.hpp), in which case pages are
+// copied on first write and the file itself is never modified.
+class Map {
+public:
+    static constexpr int ROW_ALIGNMENT = 64;
+
+    Map(int w, int h);
+    Map(const Map&) = delete;
+    Map& operator=(const Map&) = delete;
+    Map(Map&&) noexcept;
+    Map& operator=(Map&&) noexcept;
+    ~Map();
+
+    bool isMapped() const { return m_mapping != nullptr; }
+
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+    int getStride() const { return m_stride; }
+    int getWordsPerRow() const { return m_stride / 64; }
+
+    Tile getTile(int x, int y) const;
+    TileType getTileType(int x, int y) const { return m_types[index(x, y)]; }
+
+    std::span<const TileType> typeRow(int y) const;
+    std::span<const uint64_t> walkableRow(int y) const { return planeRow(m_walkable, y); }
+    std::span<const uint64_t> exploredRow(int y) const { return planeRow(m_explored.data(), y); }
+    std::span<const uint64_t> visibleRow(int y) const { return planeRow(m_visible.data(), y); }
+
+    bool isValidPosition(int x, int y) const;
+    bool isWalkable(int x, int y) const;
+    bool isExplored(int x, int y) const;
+    bool isVisible(int x, int y) const;
+
+    void setTile(int x, int y, TileType type);
+    void fillRect(int x, int y, int w, int h, TileType type);
+    // Bulk row write: tile x becomes `set` where bit x of mask is one and
+    // `unset` elsewhere, eight tiles per store. Bits past the width are ignored.
+    void assignRow(int y, std::span<const uint64_t> mask, TileType set, TileType unset);
+
+    void setExplored(int x, int y, bool explored);
+    void setVisible(int x, int y, bool visible);
+    // Makes tile x + i of row y visible for every bit i set in `bits`;
+    // bits past the width are ignored.
+    void markVisible(int x, int y, uint64_t bits);
+    void clearVisible();
+    void exploreVisible();
+    // The same, limited to a rectangle (clipped to the map). exploreVisible
+    // works in whole words, so visible tiles just outside the rectangle may
+    // be explored too.
+    void clearVisible(int x, int y, int w, int h);
+    void exploreVisible(int x, int y, int w, int h);
+
+    // Compact list of the walkable tiles, each as y * getStride() + x, in no
+    // particular order, for O(1) uniform sampling. It is built by
+    // trackWalkableCells() and kept current by every tile write after that;
+    // until then it is empty and writes pay nothing for it.
+    void trackWalkableCells();
+    bool isTrackingWalkableCells() const { return m_trackingCells; }
+    std::span<const uint32_t> walkableCells() const { return m_walkableCells; }
+    Position cellPosition(uint32_t cell) const {
+        return {static_cast<int>(cell % m_stride), static_cast<int>(cell / m_stride)};
+    }
+
+    // Walkability journal. Every tile write that flips a walkable bit
+    // advances the revision and the last CHANGE_LOG_CAPACITY such tiles are
+    // remembered, so caches derived from the walkable plane can patch what
+    // changed instead of rebuilding. Bulk writes (assignRow, clear) are not
+    // itemised. Each map starts from its own revision range, so a cache
+    // keyed on (map, revision) cannot mistake one map for another.
+    static constexpr std::size_t CHANGE_LOG_CAPACITY = 1024;
+    uint64_t getRevision() const { return m_revision; }
+    // Calls fn(position) for every walkability change after `revision`,
+    // oldest first. Returns false without calling fn when some of those
+    // changes were not recorded; the caller then has to rebuild.
+    template <typename Fn>
+    bool forEachChangeSince(uint64_t revision, Fn fn) const {
+        if (revision < m_journalStart || revision > m_revision ||
+            m_revision - revision > CHANGE_LOG_CAPACITY) {
+            return false;
+        }
+        for (uint64_t r = revision; r < m_revision; ++r) {
+            fn(cellPosition(m_changeLog[r % CHANGE_LOG_CAPACITY]));
+        }
+        return true;
+    }
+
+    std::size_t countWalkable() const { return countBits(m_walkable); }
+    std::size_t countExplored() const { return countBits(m_explored.data()); }
+    std::size_t countVisible() const { return countBits(m_visible.data()); }
+
+    Position getStairsDown() const { return m_stairsDown; }
+    void setStairsDown(Position p) { m_stairsDown = p; }
+    Position getSpawnPoint() const { return m_spawnPoint; }
+    void setSpawnPoint(Position p) { m_spawnPoint = p; }
+
+    void clear();
+
+    static Tile makeTile(TileType type);
+
+private:
+    int m_width;
+    int m_height;
+    int m_stride;
+    std::vector<TileType> m_ownedTypes;
+    std::vector<uint64_t> m_ownedWalkable;
+    std::unique_ptr<MappedFile> m_mapping;
+    TileType* m_types;
+    uint64_t* m_walkable;
+    std::vector<uint64_t> m_explored;
+    std::vector<uint64_t> m_visible;
+    Position m_stairsDown;
+    Position m_spawnPoint;
+    bool m_trackingCells = false;
+    std::vector<uint32_t> m_walkableCells;
+    // Position of each walkable tile in m_walkableCells, while tracking.
+    std::vector<uint32_t> m_cellSlot;
+    uint64_t m_revision;
+    // Oldest revision from which every change is in the log.
+    uint64_t m_journalStart;
+    std::vector<uint32_t> m_changeLog;
+
+    Map(int w, int h, std::unique_ptr<MappedFile> mapping, std::size_t typeOffset,
+        std::size_t walkableOffset);
+    friend std::unique_ptr<Map> openMapFile(const std::string& filename);
+
+    std::size_t tileCount() const { return static_cast<std::size_t>(m_stride) * m_height; }
+    std::size_t wordCount() const { return m_explored.size(); }
+
+    std::size_t index(int x, int y) const {
+        return static_cast<std::size_t>(y) * m_stride + x;
+    }
+    std::size_t wordIndex(int x, int y) const {
+        return static_cast<std::size_t>(y) * getWordsPerRow() + (x >> 6);
+    }
+    std::span<const uint64_t> planeRow(const uint64_t* plane, int y) const {
+        return {plane + wordIndex(0, y), static_cast<std::size_t>(getWordsPerRow())};
+    }
+
+    bool testBit(const uint64_t* plane, int x, int y) const;
+    void assignBit(uint64_t* plane, int x, int y, bool value);
+    std::size_t countBits(const uint64_t* plane) const;
+    // Brings the cell list in line with a walkable word going from `before`
+    // to `after`.
+    void updateCells(int y, int word, uint64_t before, uint64_t after);
+    // Journals and tracks a walkable word written from `before` to `after`.
+    void wroteWalkable(int y, int word, uint64_t before, uint64_t after);
+    // Records a write too large to itemise.
+    void wroteWalkableBulk();
+};
+
+}
+
+#endif
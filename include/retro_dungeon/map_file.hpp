@@ -0,0 +1,73 @@
+#ifndef RETRO_DUNGEON_MAP_FILE_HPP
+#define RETRO_DUNGEON_MAP_FILE_HPP
+
+#include "retro_dungeon/map.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace retro_dungeon {
+
+// Binary map file, native byte order:
+//   MapFileHeader
+//   type layer      stride * height bytes, one TileType per tile
+//   walkable plane  (stride / 64) * height 64-bit words
+// Both layers start on a MAP_FILE_ALIGNMENT boundary and use exactly the
+// in-memory layout of Map, so a loaded map points straight into the mapping.
+struct MapFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    int32_t width;
+    int32_t height;
+    int32_t stride;
+    int32_t stairsX;
+    int32_t stairsY;
+    int32_t spawnX;
+    int32_t spawnY;
+    uint32_t reserved;
+    uint64_t typeOffset;
+    uint64_t walkableOffset;
+    uint64_t fileSize;
+};
+
+inline constexpr char MAP_FILE_MAGIC[8] = {'R', 'D', 'M', 'A', 'P', '\0', '\0', '\0'};
+inline constexpr uint32_t MAP_FILE_VERSION = 2;
+inline constexpr std::size_t MAP_FILE_ALIGNMENT = 64;
+
+// A whole file mapped privately: readable and writable in memory, with
+// writes copied on demand and never reaching the file. Falls back to reading
+// the file into memory on platforms without mmap.
+class MappedFile {
+public:
+    static std::unique_ptr<MappedFile> open(const std::string& filename);
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    std::byte* data() const { return m_data; }
+    std::size_t size() const { return m_size; }
+
+private:
+    std::byte* m_data;
+    std::size_t m_size;
+    std::unique_ptr<uint64_t[]> m_buffer;
+
+    MappedFile(std::byte* data, std::size_t size, std::unique_ptr<uint64_t[]> buffer);
+};
+
+bool saveMapFile(const Map& map, const std::string& filename);
+// Checks the header only, so opening stays constant time whatever the map's
+// size; unknown tile types read as walls (see tileTraits).
+std::unique_ptr<Map> openMapFile(const std::string& filename);
+
+// Scans every tile for types outside TILE_TRAITS and walkable bits past the
+// width. O(area) and touches every page of a mapping, so it is left to
+// callers loading files they do not trust.
+bool verifyMapLayers(const Map& map);
+
+}
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef RETRO_DUNGEON_PATHFINDER_HPP
+#define RETRO_DUNGEON_PATHFINDER_HPP
+
+#include "retro_dungeon/map.hpp"
+#include "retro_dungeon/types.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace retro_dungeon {
+
+enum class Movement : uint8_t {
+    Cardinal,
+    Diagonal
+};
+
+// A* over a Map's walkable tiles. Cardinal movement uses the Manhattan
+// heuristic; Diagonal adds the four diagonal steps (never cutting a wall
+// corner) and uses the octile heuristic. Costs are integers: STRAIGHT_COST
+// per orthogonal step and DIAGONAL_COST per diagonal one.
+//
+// Per-tile search state lives in one array indexed like the map's tiles and
+// is stamped with a search generation, so starting a query never clears
+// anything. Both heuristics are consistent, so f never drops below the last
+// popped value and never rises more than two steps' cost above it: the open
+// list is a ring of BUCKET_COUNT buckets keyed by f with lazy deletion, and
+// popping the minimum is a rotate and a count of trailing zeros. Node pool
+// and open entries are kept between queries, so once sized for a map a
+// search does not allocate.
+class Pathfinder {
+public:
+    static constexpr int STRAIGHT_COST = 10;
+    static constexpr int DIAGONAL_COST = 14;
+
+    explicit Pathfinder(Movement movement = Movement::Cardinal) : m_movement(movement) {}
+
+    Movement getMovement() const { return m_movement; }
+
+    // Sizes the node pool and open list for maps of this size ahead of the
+    // first query.
+    void prepare(const Map& map);
+
+    // Shortest path from start to goal. On success `path` holds the tiles
+    // after start up to and including goal. Returns false, with `path`
+    // empty, when goal is unreachable or the search gives up after
+    // maxExpansions expanded tiles (0 means no limit).
+    bool findPath(const Map& map, Position start, Position goal, std::vector<Position>& path,
+                  std::size_t maxExpansions = 0);
+
+    // Statistics of the last query; the cost is -1 when no path was found.
+    std::size_t getExpandedCount() const { return m_expanded; }
+    int getPathCost() const { return m_pathCost; }
+
+private:
+    struct Node {
+        uint32_t stamp;
+        uint32_t g;
+        uint32_t parent;
+    };
+
+    struct OpenEntry {
+        uint32_t cell;
+        uint32_t g;
+        uint32_t next;
+    };
+
+    // Must exceed the largest f increase per expansion, 2 * DIAGONAL_COST.
+    static constexpr uint32_t BUCKET_COUNT = 32;
+    static_assert(BUCKET_COUNT > 2 * DIAGONAL_COST);
+
+    Movement m_movement;
+    std::vector<Node> m_nodes;
+    std::vector<OpenEntry> m_open;
+    std::array<uint32_t, BUCKET_COUNT> m_buckets{};
+    uint32_t m_bucketMask = 0;
+    uint32_t m_freeEntry = 0;
+    uint32_t m_generation = 0;
+    int m_stride = 0;
+    std::size_t m_expanded = 0;
+    int m_pathCost = -1;
+
+    uint32_t heuristic(int x, int y, int goalX, int goalY) const;
+    void push(uint32_t cell, uint32_t g, uint32_t f, uint32_t parent);
+    OpenEntry pop(uint32_t bucket);
+    void buildPath(uint32_t goal, std::vector<Position>& path) const;
+};
+
+}
+
+#endif
@@ -0,0 +1,174 @@
+#ifndef RETRO_DUNGEON_RANDOM_HPP
+#define RETRO_DUNGEON_RANDOM_HPP
+
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <span>
+
+namespace retro_dungeon {
+
+// Independent random streams. Each subsystem draws from its own stream so
+// that, for example, spawning more enemies never shifts the dungeon layout.
+enum class RngStream : uint32_t {
+    Generation,
+    Spawning,
+    Items,
+    Combat
+};
+
+constexpr uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// Seed for the (seed, level, stream) triple. Every stream is a pure function
+// of its key, so levels and subsystems can be generated in any order or in
+// parallel and still reproduce exactly.
+constexpr uint64_t deriveSeed(uint64_t seed, int level, RngStream stream) {
+    uint64_t key = mix64(seed + 0x9e3779b97f4a7c15ULL);
+    key = mix64(key ^ (static_cast<uint64_t>(static_cast<uint32_t>(level)) * 0xd1b54a32d192ed03ULL));
+    return mix64(key ^ ((static_cast<uint64_t>(stream) + 1) * 0xaef17502108ef2d9ULL));
+}
+
+// Counter-based generator: the n-th output is mix64(seed + n * GAMMA), so
+// skipping ahead is O(1) and split() hands out statistically independent
+// child streams. Satisfies std::uniform_random_bit_generator.
+class SplitMix64 {
+public:
+    using result_type = uint64_t;
+
+    static constexpr uint64_t GAMMA = 0x9e3779b97f4a7c15ULL;
+
+    constexpr explicit SplitMix64(uint64_t seed = 0) : m_state(seed) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    constexpr result_type operator()() {
+        m_state += GAMMA;
+        return mix64(m_state);
+    }
+
+    constexpr void discard(uint64_t count) { m_state += count * GAMMA; }
+
+    constexpr SplitMix64 split() { return SplitMix64(mix64(operator()() ^ 0x6a09e667f3bcc909ULL)); }
+
+private:
+    uint64_t m_state;
+};
+
+constexpr SplitMix64 makeStream(uint64_t seed, int level, RngStream stream) {
+    return SplitMix64(deriveSeed(seed, level, stream));
+}
+
+// xoshiro256** by Blackman and Vigna: 32 bytes of state, a handful of
+// shifts and one multiply per output. The state is expanded from a 64-bit
+// seed with SplitMix64, as the authors recommend.
+class Xoshiro256StarStar {
+public:
+    using result_type = uint64_t;
+
+    constexpr explicit Xoshiro256StarStar(uint64_t seed = 0) {
+        SplitMix64 expand(seed);
+        for (uint64_t& word : m_state) {
+            word = expand();
+        }
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    constexpr result_type operator()() {
+        const uint64_t result = rotl(m_state[1] * 5, 7) * 9;
+        const uint64_t t = m_state[1] << 17;
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotl(m_state[3], 45);
+        return result;
+    }
+
+private:
+    uint64_t m_state[4]{};
+
+    static constexpr uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+};
+
+// Engines DungeonGenerator can be instantiated with: any standard random
+// bit generator that can be seeded from a 64-bit value.
+template <typename Engine>
+concept RandomEngine =
+    std::uniform_random_bit_generator<Engine> && std::constructible_from<Engine, uint64_t>;
+
+template <std::uniform_random_bit_generator Engine>
+constexpr uint32_t random32(Engine& rng) {
+    static_assert(Engine::min() == 0 && Engine::max() >= 0xffffffffULL,
+                  "engine must produce at least 32 random bits");
+    if constexpr (Engine::max() > 0xffffffffULL) {
+        return static_cast<uint32_t>(rng() >> 32);
+    } else {
+        return static_cast<uint32_t>(rng());
+    }
+}
+
+// Unbiased integer in [0, range) using Lemire's multiply-shift method. The
+// division only runs on the rare draws that land in the biased zone.
+template <std::uniform_random_bit_generator Engine>
+constexpr uint32_t boundedRandom(Engine& rng, uint32_t range) {
+    uint64_t product = static_cast<uint64_t>(random32(rng)) * range;
+    uint32_t low = static_cast<uint32_t>(product);
+    if (low < range) {
+        const uint32_t threshold = (0u - range) % range;
+        while (low < threshold) {
+            product = static_cast<uint64_t>(random32(rng)) * range;
+            low = static_cast<uint32_t>(product);
+        }
+    }
+    return static_cast<uint32_t>(product >> 32);
+}
+
+// Uniform integer in [lo, hi]; a drop-in for std::uniform_int_distribution
+// without the per-call distribution object.
+template <std::uniform_random_bit_generator Engine>
+constexpr int uniformInt(Engine& rng, int lo, int hi) {
+    const uint32_t span = static_cast<uint32_t>(hi) - static_cast<uint32_t>(lo);
+    if (span == std::numeric_limits<uint32_t>::max()) {
+        return static_cast<int>(static_cast<uint32_t>(lo) + random32(rng));
+    }
+    return static_cast<int>(static_cast<uint32_t>(lo) + boundedRandom(rng, span + 1));
+}
+
+// Fills whole buffers at once. Value i of the stream is a pure function of
+// the key and the counter (see valueAt), so the AVX2, SSE4.1 and scalar
+// paths in random.cpp, chosen at compile time, produce bit-identical output
+// and the batch size does not change the sequence. Bounded values use a
+// single multiply-shift, which is biased by at most range / 2^32 --
+// negligible for procgen, but use uniformInt where exact uniformity matters.
+// A range of 0 means all 2^32 values.
+class BatchRng {
+public:
+    explicit BatchRng(uint64_t seed = 0);
+
+    void fillBits(std::span<uint32_t> out);
+    void fillBounded(std::span<uint32_t> out, uint32_t range);
+    void fillInts(std::span<int> out, int lo, int hi);
+    void fillFloats(std::span<float> out);
+
+    uint32_t valueAt(uint64_t counter) const;
+    uint64_t getCounter() const { return m_counter; }
+    void seek(uint64_t counter) { m_counter = counter; }
+
+private:
+    uint32_t m_keyLow;
+    uint32_t m_keyHigh;
+    uint64_t m_counter = 0;
+};
+
+}
+
+#endif
@@ -0,0 +1,136 @@
+#ifndef RETRO_DUNGEON_SPATIAL_GRID_HPP
+#define RETRO_DUNGEON_SPATIAL_GRID_HPP
+
+#include "retro_dungeon/types.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace retro_dungeon {
+
+// Dense tile -> occupant index laid out like Map: one T per tile, plus an
+// occupancy bitplane (64 tiles per word, rows padded to whole words) so
+// scans skip empty stretches a word at a time. A tile holds at most one
+// occupant; T{} means empty, so T is typically a pointer or handle.
+//
+// The owner keeps it up to date with place/move/remove; every operation
+// except the scans is O(1).
+template <typename T>
+class SpatialGrid {
+public:
+    SpatialGrid() = default;
+    SpatialGrid(int width, int height) { reset(width, height); }
+
+    void reset(int width, int height) {
+        m_width = width;
+        m_height = height;
+        m_wordsPerRow = (width + 63) / 64;
+        m_cells.assign(static_cast<std::size_t>(width) * height, T{});
+        m_occupied.assign(static_cast<std::size_t>(m_wordsPerRow) * height, 0);
+        m_count = 0;
+    }
+
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+    std::size_t size() const { return m_count; }
+
+    bool isValidPosition(Position p) const {
+        return p.first >= 0 && p.first < m_width && p.second >= 0 && p.second < m_height;
+    }
+
+    T at(Position p) const { return isValidPosition(p) ? m_cells[index(p)] : T{}; }
+    bool isOccupied(Position p) const { return isValidPosition(p) && testBit(p); }
+
+    // False when the tile is off the grid or already taken.
+    bool place(Position p, T value) {
+        if (!isValidPosition(p) || testBit(p)) return false;
+        m_cells[index(p)] = value;
+        flipBit(p);
+        ++m_count;
+        return true;
+    }
+
+    // Moves the occupant of `from`; false (and nothing changes) when `from`
+    // is empty or `to` is off the grid or taken.
+    bool move(Position from, Position to) {
+        if (!isOccupied(from) || !isValidPosition(to) || testBit(to)) return false;
+        m_cells[index(to)] = m_cells[index(from)];
+        m_cells[index(from)] = T{};
+        flipBit(from);
+        flipBit(to);
+        return true;
+    }
+
+    void remove(Position p) {
+        if (!isOccupied(p)) return;
+        m_cells[index(p)] = T{};
+        flipBit(p);
+        --m_count;
+    }
+
+    // Calls fn(position, occupant) for every occupant within `radius` tiles
+    // (Euclidean) of center, row by row.
+    template <typename Fn>
+    void forEachInRadius(Position center, int radius, Fn fn) const {
+        if (radius < 0) return;
+        const int y0 = std::max(center.second - radius, 0);
+        const int y1 = std::min(center.second + radius, m_height - 1);
+        for (int y = y0; y <= y1; ++y) {
+            const int dy = y - center.second;
+            const int reach =
+                static_cast<int>(std::sqrt(static_cast<double>(radius * radius - dy * dy)));
+            scanRow(y, center.first - reach, center.first + reach, fn);
+        }
+    }
+
+    // Calls fn(position, occupant) for every occupant in raster order.
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (int y = 0; y < m_height; ++y) {
+            scanRow(y, 0, m_width - 1, fn);
+        }
+    }
+
+private:
+    int m_width = 0;
+    int m_height = 0;
+    int m_wordsPerRow = 0;
+    std::vector<T> m_cells;
+    std::vector<uint64_t> m_occupied;
+    std::size_t m_count = 0;
+
+    std::size_t index(Position p) const {
+        return static_cast<std::size_t>(p.second) * m_width + p.first;
+    }
+    std::size_t wordIndex(Position p) const {
+        return static_cast<std::size_t>(p.second) * m_wordsPerRow + (p.first >> 6);
+    }
+    bool testBit(Position p) const { return (m_occupied[wordIndex(p)] >> (p.first & 63)) & 1; }
+    void flipBit(Position p) { m_occupied[wordIndex(p)] ^= uint64_t{1} << (p.first & 63); }
+
+    template <typename Fn>
+    void scanRow(int y, int x0, int x1, Fn& fn) const {
+        x0 = std::max(x0, 0);
+        x1 = std::min(x1, m_width - 1);
+        if (x0 > x1) return;
+
+        const uint64_t* row = &m_occupied[static_cast<std::size_t>(y) * m_wordsPerRow];
+        for (int word = x0 >> 6; word <= x1 >> 6; ++word) {
+            uint64_t bits = row[word];
+            if (word == x0 >> 6) bits &= ~uint64_t{0} << (x0 & 63);
+            if (word == x1 >> 6) bits &= ~uint64_t{0} >> (63 - (x1 & 63));
+            while (bits != 0) {
+                const Position p{word * 64 + std::countr_zero(bits), y};
+                bits &= bits - 1;
+                fn(p, m_cells[index(p)]);
+            }
+        }
+    }
+};
+
+}
+
+#endif
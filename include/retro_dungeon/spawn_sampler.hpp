@@ -0,0 +1,71 @@
+#ifndef RETRO_DUNGEON_SPAWN_SAMPLER_HPP
+#define RETRO_DUNGEON_SPAWN_SAMPLER_HPP
+
+#include "retro_dungeon/map.hpp"
+#include "retro_dungeon/random.hpp"
+#include "retro_dungeon/types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace retro_dungeon {
+
+// Hands out uniformly random walkable tiles that nothing occupies yet, so
+// thousands of entities can be scattered over a level without collisions or
+// rejection sampling against walls. The candidates start as a copy of the
+// map's walkable cell list. Each draw swaps its pick past the end of the
+// live range (a partial Fisher-Yates shuffle). Tiles claimed through
+// occupy() stay in the list and are discarded when drawn, so every draw is
+// amortised O(1).
+class SpawnSampler {
+public:
+    // The map must be tracking its walkable cells.
+    void reset(const Map& map);
+
+    // Marks a tile as taken; false when it already was or is off the map.
+    bool occupy(Position p);
+    bool isOccupied(Position p) const;
+    // Upper bound on the tiles still available.
+    std::size_t remaining() const { return m_live; }
+
+    // A free walkable tile, now marked occupied, or INVALID_POSITION once
+    // the level is full.
+    template <std::uniform_random_bit_generator Engine>
+    Position sample(Engine& rng) {
+        while (m_live > 0) {
+            const auto pick = static_cast<std::size_t>(uniformInt(rng, 0, static_cast<int>(m_live) - 1));
+            const uint32_t cell = m_candidates[pick];
+            m_candidates[pick] = m_candidates[--m_live];
+            m_candidates[m_live] = cell;
+            if (claim(cell)) return {static_cast<int>(cell % m_stride), static_cast<int>(cell / m_stride)};
+        }
+        return INVALID_POSITION;
+    }
+
+    // Fills `out` with distinct free tiles; returns how many were found.
+    template <std::uniform_random_bit_generator Engine>
+    std::size_t sampleBatch(Engine& rng, std::span<Position> out) {
+        std::size_t count = 0;
+        for (; count < out.size(); ++count) {
+            out[count] = sample(rng);
+            if (out[count] == INVALID_POSITION) break;
+        }
+        return count;
+    }
+
+private:
+    int m_width = 0;
+    int m_height = 0;
+    int m_stride = 0;
+    std::vector<uint32_t> m_candidates;
+    std::size_t m_live = 0;
+    // One bit per cell index, padded rows included.
+    std::vector<uint64_t> m_occupied;
+
+    bool claim(uint32_t cell);
+};
+
+}
+
+#endif
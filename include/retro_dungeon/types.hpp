@@ -19,7 +19,7 @@ struct PositionHash {
     }
 };
 
-enum class TileType {
+enum class TileType : uint8_t {
     Floor,
     Wall,
     Door,
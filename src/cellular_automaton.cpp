@@ -0,0 +1,175 @@
+#include "retro_dungeon/cellular_automaton.hpp"
+#include <algorithm>
+#include <bit>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace retro_dungeon {
+
+namespace {
+
+struct ScalarOps {
+    using Word = uint64_t;
+    static constexpr std::size_t LANES = 1;
+
+    static Word load(const uint64_t* p) { return *p; }
+    static void store(uint64_t* p, Word v) { *p = v; }
+    static Word shiftLeft(Word v, int n) { return v << n; }
+    static Word shiftRight(Word v, int n) { return v >> n; }
+    static Word andOf(Word a, Word b) { return a & b; }
+    static Word orOf(Word a, Word b) { return a | b; }
+    static Word xorOf(Word a, Word b) { return a ^ b; }
+    static Word andNot(Word a, Word b) { return ~a & b; }
+};
+
+#if defined(__AVX2__)
+struct VectorOps {
+    using Word = __m256i;
+    static constexpr std::size_t LANES = 4;
+
+    static Word load(const uint64_t* p) { return _mm256_loadu_si256(reinterpret_cast<const Word*>(p)); }
+    static void store(uint64_t* p, Word v) { _mm256_storeu_si256(reinterpret_cast<Word*>(p), v); }
+    static Word shiftLeft(Word v, int n) { return _mm256_slli_epi64(v, n); }
+    static Word shiftRight(Word v, int n) { return _mm256_srli_epi64(v, n); }
+    static Word andOf(Word a, Word b) { return _mm256_and_si256(a, b); }
+    static Word orOf(Word a, Word b) { return _mm256_or_si256(a, b); }
+    static Word xorOf(Word a, Word b) { return _mm256_xor_si256(a, b); }
+    static Word andNot(Word a, Word b) { return _mm256_andnot_si256(a, b); }
+};
+#elif defined(__SSE2__)
+struct VectorOps {
+    using Word = __m128i;
+    static constexpr std::size_t LANES = 2;
+
+    static Word load(const uint64_t* p) { return _mm_loadu_si128(reinterpret_cast<const Word*>(p)); }
+    static void store(uint64_t* p, Word v) { _mm_storeu_si128(reinterpret_cast<Word*>(p), v); }
+    static Word shiftLeft(Word v, int n) { return _mm_slli_epi64(v, n); }
+    static Word shiftRight(Word v, int n) { return _mm_srli_epi64(v, n); }
+    static Word andOf(Word a, Word b) { return _mm_and_si128(a, b); }
+    static Word orOf(Word a, Word b) { return _mm_or_si128(a, b); }
+    static Word xorOf(Word a, Word b) { return _mm_xor_si128(a, b); }
+    static Word andNot(Word a, Word b) { return _mm_andnot_si128(a, b); }
+};
+#endif
+
+// Neighbour at x - 1 (west) or x + 1 (east) moved into bit x, pulling the
+// edge bit in from the adjacent word.
+template <typename Ops>
+typename Ops::Word west(const uint64_t* p) {
+    return Ops::orOf(Ops::shiftLeft(Ops::load(p), 1), Ops::shiftRight(Ops::load(p - 1), 63));
+}
+
+template <typename Ops>
+typename Ops::Word east(const uint64_t* p) {
+    return Ops::orOf(Ops::shiftRight(Ops::load(p), 1), Ops::shiftLeft(Ops::load(p + 1), 63));
+}
+
+template <typename Ops>
+typename Ops::Word majority(typename Ops::Word a, typename Ops::Word b, typename Ops::Word c) {
+    return Ops::orOf(Ops::andOf(a, b), Ops::andOf(c, Ops::xorOf(a, b)));
+}
+
+// Next state for Ops::LANES words starting at the given positions. The three
+// tiles above and below are summed into two-bit counts, the two beside the
+// tile into another, and those are added into a four-bit count s3..s0.
+template <typename Ops>
+typename Ops::Word nextWords(const uint64_t* above, const uint64_t* row, const uint64_t* below) {
+    using Word = typename Ops::Word;
+
+    const Word aw = west<Ops>(above), a = Ops::load(above), ae = east<Ops>(above);
+    const Word bw = west<Ops>(below), b = Ops::load(below), be = east<Ops>(below);
+    const Word cw = west<Ops>(row), ce = east<Ops>(row);
+
+    const Word a0 = Ops::xorOf(Ops::xorOf(aw, a), ae);
+    const Word a1 = majority<Ops>(aw, a, ae);
+    const Word b0 = Ops::xorOf(Ops::xorOf(bw, b), be);
+    const Word b1 = majority<Ops>(bw, b, be);
+    const Word m0 = Ops::xorOf(cw, ce);
+    const Word m1 = Ops::andOf(cw, ce);
+
+    const Word s0 = Ops::xorOf(Ops::xorOf(a0, b0), m0);
+    const Word carry = majority<Ops>(a0, b0, m0);
+    const Word twos = Ops::xorOf(Ops::xorOf(a1, b1), m1);
+    const Word fours = majority<Ops>(a1, b1, m1);
+    const Word s1 = Ops::xorOf(twos, carry);
+    const Word fourCarry = Ops::andOf(twos, carry);
+    const Word s2 = Ops::xorOf(fours, fourCarry);
+    const Word s3 = Ops::andOf(fours, fourCarry);
+
+    const Word low = Ops::orOf(s1, s0);
+    const Word atLeastFive = Ops::orOf(s3, Ops::andOf(s2, low));
+    const Word exactlyFour = Ops::andNot(low, s2);
+    return Ops::orOf(atLeastFive, Ops::andOf(Ops::load(row), exactlyFour));
+}
+
+}
+
+Bitboard::Bitboard(int width, int height, bool outside)
+    : m_width(width), m_height(height), m_wordsPerRow((width + 63) / 64),
+      m_pitch(m_wordsPerRow + 2), m_outside(outside ? ~uint64_t{0} : 0),
+      m_lastWordMask(width % 64 == 0 ? ~uint64_t{0} : (uint64_t{1} << (width % 64)) - 1),
+      m_bits(static_cast<std::size_t>(m_pitch) * (height + 2), m_outside) {
+    for (int y = 0; y < m_height; ++y) {
+        std::fill(row(y).begin(), row(y).end(), 0);
+    }
+    resetPadding();
+}
+
+bool Bitboard::test(int x, int y) const {
+    if (x < 0 || x >= m_width || y < 0 || y >= m_height) return m_outside != 0;
+    return (rowData(y)[x >> 6] >> (x & 63)) & 1;
+}
+
+void Bitboard::set(int x, int y, bool value) {
+    if (x < 0 || x >= m_width || y < 0 || y >= m_height) return;
+    const uint64_t bit = uint64_t{1} << (x & 63);
+    if (value) {
+        rowData(y)[x >> 6] |= bit;
+    } else {
+        rowData(y)[x >> 6] &= ~bit;
+    }
+}
+
+std::size_t Bitboard::count() const {
+    std::size_t total = 0;
+    for (int y = 0; y < m_height; ++y) {
+        const uint64_t* words = rowData(y);
+        for (int i = 0; i < m_wordsPerRow - 1; ++i) {
+            total += std::popcount(words[i]);
+        }
+        total += std::popcount(words[m_wordsPerRow - 1] & m_lastWordMask);
+    }
+    return total;
+}
+
+void Bitboard::resetPadding() {
+    for (int y = 0; y < m_height; ++y) {
+        uint64_t& last = rowData(y)[m_wordsPerRow - 1];
+        last = (last & m_lastWordMask) | (m_outside & ~m_lastWordMask);
+    }
+}
+
+void stepCaveAutomaton(const Bitboard& walls, Bitboard& next) {
+    const auto words = static_cast<std::size_t>(walls.m_wordsPerRow);
+    for (int y = 0; y < walls.m_height; ++y) {
+        const uint64_t* above = walls.rowData(y - 1);
+        const uint64_t* row = walls.rowData(y);
+        const uint64_t* below = walls.rowData(y + 1);
+        uint64_t* out = next.rowData(y);
+
+        std::size_t i = 0;
+#if defined(__AVX2__) || defined(__SSE2__)
+        for (; i + VectorOps::LANES <= words; i += VectorOps::LANES) {
+            VectorOps::store(out + i, nextWords<VectorOps>(above + i, row + i, below + i));
+        }
+#endif
+        for (; i < words; ++i) {
+            out[i] = nextWords<ScalarOps>(above + i, row + i, below + i);
+        }
+    }
+    next.resetPadding();
+}
+
+}
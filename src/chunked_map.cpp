@@ -0,0 +1,188 @@
+#include "retro_dungeon/chunked_map.hpp"
+#include <algorithm>
+
+namespace retro_dungeon {
+
+namespace {
+
+constexpr int CHUNK_SHIFT = 5;
+constexpr int CHUNK_MASK = ChunkedMap::CHUNK_SIZE - 1;
+
+static_assert((1 << CHUNK_SHIFT) == ChunkedMap::CHUNK_SIZE);
+
+int localIndex(int x, int y) {
+    return ((y & CHUNK_MASK) << CHUNK_SHIFT) | (x & CHUNK_MASK);
+}
+
+}
+
+bool ChunkedMap::Chunk::isBlank() const {
+    if (openTiles != 0) return false;
+    return std::all_of(explored.begin(), explored.end(), [](uint32_t row) { return row == 0; });
+}
+
+ChunkedMap::ChunkedMap(int w, int h) : m_width(w), m_height(h), m_stairsDown(INVALID_POSITION) {}
+
+Tile ChunkedMap::getTile(int x, int y) const {
+    const Chunk& chunk = chunkAt(x, y);
+    Tile tile = Map::makeTile(chunk.types[localIndex(x, y)]);
+    tile.explored = (chunk.explored[y & CHUNK_MASK] >> (x & CHUNK_MASK)) & 1;
+    return tile;
+}
+
+TileType ChunkedMap::getTileType(int x, int y) const {
+    return chunkAt(x, y).types[localIndex(x, y)];
+}
+
+bool ChunkedMap::isValidPosition(int x, int y) const {
+    return x >= 0 && x < m_width && y >= 0 && y < m_height;
+}
+
+bool ChunkedMap::isWalkable(int x, int y) const {
+    if (!isValidPosition(x, y)) return false;
+    return (chunkAt(x, y).walkable[y & CHUNK_MASK] >> (x & CHUNK_MASK)) & 1;
+}
+
+bool ChunkedMap::isExplored(int x, int y) const {
+    if (!isValidPosition(x, y)) return false;
+    return (chunkAt(x, y).explored[y & CHUNK_MASK] >> (x & CHUNK_MASK)) & 1;
+}
+
+void ChunkedMap::setTile(int x, int y, TileType type) {
+    if (!isValidPosition(x, y)) return;
+
+    Chunk* chunk = findChunk(x, y);
+    if (!chunk) {
+        if (type == TileType::Wall) return;
+        chunk = &chunkForWrite(x, y);
+    }
+
+    TileType& slot = chunk->types[localIndex(x, y)];
+    chunk->openTiles += (type != TileType::Wall) - (slot != TileType::Wall);
+    slot = type;
+
+    uint32_t mask = uint32_t{1} << (x & CHUNK_MASK);
+    if (tileTraits(type).walkable) {
+        chunk->walkable[y & CHUNK_MASK] |= mask;
+    } else {
+        chunk->walkable[y & CHUNK_MASK] &= ~mask;
+    }
+    releaseIfBlank(x, y, *chunk);
+}
+
+void ChunkedMap::setExplored(int x, int y, bool explored) {
+    if (!isValidPosition(x, y)) return;
+
+    Chunk* chunk = findChunk(x, y);
+    if (!chunk) {
+        if (!explored) return;
+        chunk = &chunkForWrite(x, y);
+    }
+
+    uint32_t mask = uint32_t{1} << (x & CHUNK_MASK);
+    if (explored) {
+        chunk->explored[y & CHUNK_MASK] |= mask;
+    } else {
+        chunk->explored[y & CHUNK_MASK] &= ~mask;
+    }
+    releaseIfBlank(x, y, *chunk);
+}
+
+void ChunkedMap::fillRect(int x, int y, int w, int h, TileType type) {
+    int x0 = std::max(x, 0);
+    int y0 = std::max(y, 0);
+    int x1 = std::min(x + w, m_width);
+    int y1 = std::min(y + h, m_height);
+    if (x0 >= x1 || y0 >= y1) return;
+
+    const bool walkable = tileTraits(type).walkable;
+    const int open = type != TileType::Wall;
+
+    for (int cy = y0 & ~CHUNK_MASK; cy < y1; cy += CHUNK_SIZE) {
+        for (int cx = x0 & ~CHUNK_MASK; cx < x1; cx += CHUNK_SIZE) {
+            Chunk* chunk = findChunk(cx, cy);
+            if (!chunk) {
+                if (!open) continue;
+                chunk = &chunkForWrite(cx, cy);
+            }
+
+            int lx0 = std::max(x0, cx) - cx;
+            int lx1 = std::min(x1, cx + CHUNK_SIZE) - cx;
+            int ly0 = std::max(y0, cy) - cy;
+            int ly1 = std::min(y1, cy + CHUNK_SIZE) - cy;
+            int width = lx1 - lx0;
+            uint32_t mask = (width == 32 ? ~uint32_t{0} : ((uint32_t{1} << width) - 1)) << lx0;
+
+            for (int ly = ly0; ly < ly1; ++ly) {
+                TileType* first = chunk->types.data() + (ly << CHUNK_SHIFT);
+                for (int lx = lx0; lx < lx1; ++lx) {
+                    chunk->openTiles += open - (first[lx] != TileType::Wall);
+                    first[lx] = type;
+                }
+                if (walkable) {
+                    chunk->walkable[ly] |= mask;
+                } else {
+                    chunk->walkable[ly] &= ~mask;
+                }
+            }
+            releaseIfBlank(cx, cy, *chunk);
+        }
+    }
+}
+
+void ChunkedMap::blit(const Map& map, int originX, int originY) {
+    for (int y = 0; y < map.getHeight(); ++y) {
+        auto types = map.typeRow(y);
+        for (int x = 0; x < map.getWidth(); ++x) {
+            if (types[x] != getTileType(originX + x, originY + y)) {
+                setTile(originX + x, originY + y, types[x]);
+            }
+        }
+    }
+}
+
+std::size_t ChunkedMap::getMemoryUsage() const {
+    return sizeof(*this) + m_chunks.size() * (sizeof(Chunk) + sizeof(void*) * 4) +
+           m_chunks.bucket_count() * sizeof(void*);
+}
+
+void ChunkedMap::clear() {
+    m_chunks.clear();
+    m_stairsDown = INVALID_POSITION;
+}
+
+const ChunkedMap::Chunk& ChunkedMap::wallChunk() {
+    static const Chunk sentinel;
+    return sentinel;
+}
+
+uint64_t ChunkedMap::chunkKey(int x, int y) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(y >> CHUNK_SHIFT)) << 32) |
+           static_cast<uint32_t>(x >> CHUNK_SHIFT);
+}
+
+const ChunkedMap::Chunk& ChunkedMap::chunkAt(int x, int y) const {
+    auto it = m_chunks.find(chunkKey(x, y));
+    return it == m_chunks.end() ? wallChunk() : *it->second;
+}
+
+ChunkedMap::Chunk* ChunkedMap::findChunk(int x, int y) {
+    auto it = m_chunks.find(chunkKey(x, y));
+    return it == m_chunks.end() ? nullptr : it->second.get();
+}
+
+ChunkedMap::Chunk& ChunkedMap::chunkForWrite(int x, int y) {
+    auto& slot = m_chunks[chunkKey(x, y)];
+    if (!slot) {
+        slot = std::make_unique<Chunk>();
+    }
+    return *slot;
+}
+
+void ChunkedMap::releaseIfBlank(int x, int y, const Chunk& chunk) {
+    if (chunk.isBlank()) {
+        m_chunks.erase(chunkKey(x, y));
+    }
+}
+
+}
@@ -0,0 +1,192 @@
+#include "retro_dungeon/connectivity.hpp"
+#include <algorithm>
+#include <bit>
+#include <iterator>
+#include <thread>
+
+namespace retro_dungeon {
+
+namespace {
+
+// Below this many tiles per strip, thread start-up costs more than it saves.
+constexpr std::size_t MIN_TILES_PER_STRIP = std::size_t{1} << 18;
+
+// Runs of one strip. While labeling, a run's label is its union-find parent
+// (strip-local in pass 1). rowStart[r] is the first run of the strip's r-th
+// row, and rowStart.back() is the run count.
+struct Strip {
+    std::vector<LabeledRun> runs;
+    std::vector<int32_t> rowStart;
+    int32_t offset = 0;
+};
+
+// Path halving keeps every parent at or below its child's index.
+int32_t findRoot(LabeledRun* runs, int32_t i) {
+    while (runs[i].label != i) {
+        runs[i].label = runs[runs[i].label].label;
+        i = runs[i].label;
+    }
+    return i;
+}
+
+void unite(LabeledRun* runs, int32_t a, int32_t b) {
+    a = findRoot(runs, a);
+    b = findRoot(runs, b);
+    if (a < b) {
+        runs[b].label = a;
+    } else if (b < a) {
+        runs[a].label = b;
+    }
+}
+
+// Unites every run in [above, aboveEnd) with the runs in [below, belowEnd)
+// it shares a column with. Both ranges are sorted by x.
+void uniteRows(LabeledRun* runs, int32_t above, int32_t aboveEnd, int32_t below,
+               int32_t belowEnd) {
+    while (above < aboveEnd && below < belowEnd) {
+        const LabeledRun& a = runs[above];
+        const LabeledRun& b = runs[below];
+        if (a.x0 < b.x1 && b.x0 < a.x1) unite(runs, above, below);
+        if (a.x1 < b.x1) {
+            ++above;
+        } else {
+            ++below;
+        }
+    }
+}
+
+// First x >= from whose walkable bit equals `walkable`, or width.
+int nextEdge(std::span<const uint64_t> row, int from, int width, bool walkable) {
+    const uint64_t flip = walkable ? 0 : ~uint64_t{0};
+    std::size_t word = static_cast<std::size_t>(from) >> 6;
+    uint64_t bits = (row[word] ^ flip) & (~uint64_t{0} << (from & 63));
+    while (bits == 0) {
+        if (++word == row.size()) return width;
+        bits = row[word] ^ flip;
+    }
+    return std::min(width, static_cast<int>(word * 64) + std::countr_zero(bits));
+}
+
+void include(Component& component, const LabeledRun& run) {
+    component.size += static_cast<std::size_t>(run.x1 - run.x0);
+    component.minX = std::min(component.minX, run.x0);
+    component.minY = std::min(component.minY, run.y);
+    component.maxX = std::max(component.maxX, run.x1 - 1);
+    component.maxY = std::max(component.maxY, run.y);
+}
+
+// Runs fn(strip) for every strip, the first on the calling thread.
+template <typename Fn>
+void forEachStrip(int strips, Fn fn) {
+    std::vector<std::jthread> workers;
+    workers.reserve(static_cast<std::size_t>(strips - 1));
+    for (int s = 1; s < strips; ++s) {
+        workers.emplace_back([&fn, s] { fn(s); });
+    }
+    fn(0);
+}
+
+}
+
+void ComponentLabels::build(const Map& map, int threads) {
+    m_width = map.getWidth();
+    m_height = map.getHeight();
+    m_runs.clear();
+    m_rowStart.clear();
+    m_components.clear();
+    if (m_width <= 0 || m_height <= 0) return;
+
+    const std::size_t tiles = static_cast<std::size_t>(m_width) * m_height;
+    if (threads <= 0) {
+        threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        threads = static_cast<int>(std::min<std::size_t>(threads, tiles / MIN_TILES_PER_STRIP + 1));
+    }
+    const int stripCount = std::clamp(threads, 1, m_height);
+    auto firstRow = [&](int s) {
+        return static_cast<int>(static_cast<int64_t>(m_height) * s / stripCount);
+    };
+
+    // Pass 1: collect each strip's runs and unite them with the row above.
+    std::vector<Strip> strips(static_cast<std::size_t>(stripCount));
+    forEachStrip(stripCount, [&](int s) {
+        Strip& strip = strips[s];
+        const int y0 = firstRow(s);
+        const int y1 = firstRow(s + 1);
+        strip.rowStart.reserve(static_cast<std::size_t>(y1 - y0) + 1);
+        for (int y = y0; y < y1; ++y) {
+            const auto rowBegin = static_cast<int32_t>(strip.runs.size());
+            strip.rowStart.push_back(rowBegin);
+            auto row = map.walkableRow(y);
+            for (int x = nextEdge(row, 0, m_width, true); x < m_width;) {
+                const int end = nextEdge(row, x, m_width, false);
+                const auto index = static_cast<int32_t>(strip.runs.size());
+                strip.runs.push_back({x, end, y, index});
+                x = end < m_width ? nextEdge(row, end, m_width, true) : m_width;
+            }
+            if (y > y0) {
+                uniteRows(strip.runs.data(), strip.rowStart[y - y0 - 1], rowBegin, rowBegin,
+                          static_cast<int32_t>(strip.runs.size()));
+            }
+        }
+        strip.rowStart.push_back(static_cast<int32_t>(strip.runs.size()));
+    });
+
+    // Join the strips into one run list, then unite across the borders.
+    m_rowStart.reserve(static_cast<std::size_t>(m_height) + 1);
+    for (Strip& strip : strips) {
+        strip.offset = static_cast<int32_t>(m_runs.size());
+        for (LabeledRun run : strip.runs) {
+            run.label += strip.offset;
+            m_runs.push_back(run);
+        }
+        for (std::size_t r = 0; r + 1 < strip.rowStart.size(); ++r) {
+            m_rowStart.push_back(strip.rowStart[r] + strip.offset);
+        }
+    }
+    m_rowStart.push_back(static_cast<int32_t>(m_runs.size()));
+
+    for (int s = 1; s < stripCount; ++s) {
+        const int y = firstRow(s);
+        uniteRows(m_runs.data(), m_rowStart[y - 1], m_rowStart[y], m_rowStart[y],
+                  m_rowStart[y + 1]);
+    }
+
+    // Pass 2: every parent precedes its child, so one forward pass turns
+    // parents into component ids. A root takes the next id; anything else
+    // copies its parent's, which is already final.
+    int32_t count = 0;
+    for (std::size_t i = 0; i < m_runs.size(); ++i) {
+        const int32_t parent = m_runs[i].label;
+        m_runs[i].label = parent == static_cast<int32_t>(i) ? count++ : m_runs[parent].label;
+    }
+    m_components.resize(static_cast<std::size_t>(count));
+    for (const LabeledRun& run : m_runs) {
+        include(m_components[run.label], run);
+    }
+}
+
+int ComponentLabels::getLabel(int x, int y) const {
+    if (x < 0 || x >= m_width || y < 0 || y >= m_height) return NONE;
+    const auto first = m_runs.begin() + m_rowStart[y];
+    const auto last = m_runs.begin() + m_rowStart[y + 1];
+    auto next = std::upper_bound(first, last, x,
+                                 [](int value, const LabeledRun& run) { return value < run.x0; });
+    if (next == first || std::prev(next)->x1 <= x) return NONE;
+    return std::prev(next)->label;
+}
+
+int ComponentLabels::getLargest() const {
+    auto largest = std::max_element(m_components.begin(), m_components.end(),
+                                    [](const Component& a, const Component& b) {
+                                        return a.size < b.size;
+                                    });
+    return largest == m_components.end() ? NONE
+                                         : static_cast<int>(largest - m_components.begin());
+}
+
+bool ComponentLabels::isConnected(Position a, Position b) const {
+    const int label = getLabel(a.first, a.second);
+    return label != NONE && label == getLabel(b.first, b.second);
+}
+
+}
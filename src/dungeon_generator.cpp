@@ -0,0 +1,254 @@
+#include "retro_dungeon/dungeon_generator.hpp"
+#include "retro_dungeon/cellular_automaton.hpp"
+#include "retro_dungeon/connectivity.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+
+namespace retro_dungeon {
+
+namespace {
+
+uint64_t randomSeed() {
+    std::random_device device;
+    return (static_cast<uint64_t>(device()) << 32) | device();
+}
+
+}
+
+template <RandomEngine Engine>
+BasicDungeonGenerator<Engine>::BasicDungeonGenerator() : BasicDungeonGenerator(randomSeed()) {}
+
+template <RandomEngine Engine>
+BasicDungeonGenerator<Engine>::BasicDungeonGenerator(uint64_t seed)
+    : m_seed(seed), m_rng(seed), m_batchRng(seed) {}
+
+template <RandomEngine Engine>
+std::unique_ptr<Map> BasicDungeonGenerator<Engine>::generate(int width, int height,
+                                                           DungeonStyle style) {
+    auto map = std::make_unique<Map>(width, height);
+    m_nodes.clear();
+    if (width < MIN_ROOM_SIZE + 2 || height < MIN_ROOM_SIZE + 2) return map;
+
+    Position stairs;
+    if (style == DungeonStyle::Caves) {
+        generateCaves(*map);
+        stairs = findValidPosition(*map);
+        if (stairs == INVALID_POSITION) return map;
+        map->setStairsDown(stairs);
+        map->setSpawnPoint(findValidPosition(*map));
+    } else {
+        generateRooms(*map);
+        generateCorridors(*map);
+
+        const Rect& start = leafAlong(0).room;
+        map->setSpawnPoint({start.x + start.width / 2, start.y + start.height / 2});
+
+        stairs = randomPointIn(leafAlong(1).room);
+        while (stairs == map->getSpawnPoint()) {
+            stairs = randomPointIn(leafAlong(1).room);
+        }
+    }
+
+    map->setTile(stairs.first, stairs.second, TileType::StairsDown);
+    map->setStairsDown(stairs);
+    return map;
+}
+
+template <RandomEngine Engine>
+void BasicDungeonGenerator<Engine>::generateRooms(Map& map) {
+    // Every leaf is at least MIN_LEAF_SIZE on both sides, which bounds the
+    // leaf count; a binary tree has fewer than twice as many nodes.
+    const std::size_t maxLeaves =
+        static_cast<std::size_t>(std::max(1, map.getWidth() / MIN_LEAF_SIZE)) *
+        std::max(1, map.getHeight() / MIN_LEAF_SIZE);
+    m_nodes.reserve(2 * maxLeaves);
+    m_nodes.push_back({{0, 0, map.getWidth(), map.getHeight()}, {}, -1, INVALID_POSITION});
+
+    // Depth first, so consecutive rooms (and, in generateCorridors, consecutive
+    // corridors) are close together in memory. Each split shrinks a side by at
+    // least MIN_LEAF_SIZE, which bounds the depth.
+    m_pending.clear();
+    m_pending.reserve((map.getWidth() + map.getHeight()) / MIN_LEAF_SIZE + 2);
+    m_pending.push_back(0);
+    while (!m_pending.empty()) {
+        const int i = m_pending.back();
+        m_pending.pop_back();
+        if (splitNode(i)) {
+            m_pending.push_back(m_nodes[i].firstChild + 1);
+            m_pending.push_back(m_nodes[i].firstChild);
+            continue;
+        }
+
+        Node& leaf = m_nodes[i];
+        const Rect& area = leaf.area;
+        int roomW = uniformInt(m_rng, MIN_ROOM_SIZE, area.width - 2);
+        int roomH = uniformInt(m_rng, MIN_ROOM_SIZE, area.height - 2);
+        int roomX = uniformInt(m_rng, area.x + 1, area.x + area.width - 1 - roomW);
+        int roomY = uniformInt(m_rng, area.y + 1, area.y + area.height - 1 - roomH);
+
+        leaf.room = {roomX, roomY, roomW, roomH};
+        leaf.anchor = {roomX + roomW / 2, roomY + roomH / 2};
+        map.fillRect(roomX, roomY, roomW, roomH, TileType::Floor);
+    }
+}
+
+template <RandomEngine Engine>
+void BasicDungeonGenerator<Engine>::generateCorridors(Map& map) {
+    // Children are always stored after their parent, so walking the array
+    // backwards finishes both subtrees before joining them.
+    for (std::size_t i = m_nodes.size(); i-- > 0;) {
+        Node& node = m_nodes[i];
+        if (node.firstChild < 0) continue;
+
+        const Node& first = m_nodes[node.firstChild];
+        const Node& second = m_nodes[node.firstChild + 1];
+        carveCorridor(map, first.anchor, second.anchor);
+        node.anchor = uniformInt(m_rng, 0, 1) ? first.anchor : second.anchor;
+    }
+}
+
+template <RandomEngine Engine>
+void BasicDungeonGenerator<Engine>::generateCaves(Map& map) {
+    Bitboard walls(map.getWidth(), map.getHeight(), true);
+    Bitboard next(map.getWidth(), map.getHeight(), true);
+
+    // Each tile starts as a wall with probability 15/32, from five random
+    // words combined as a & (b | c | d | e). At 1/2 the caves stop
+    // percolating on large maps and most of the open area is cut off.
+    const auto words = static_cast<std::size_t>(walls.getWordsPerRow());
+    std::vector<uint32_t> noise(10 * words);
+    auto word = [&](std::size_t k) { return noise[2 * k] | uint64_t{noise[2 * k + 1]} << 32; };
+    for (int y = 0; y < map.getHeight(); ++y) {
+        m_batchRng.fillBits(noise);
+        auto row = walls.row(y);
+        for (std::size_t i = 0; i < words; ++i) {
+            const std::size_t k = 5 * i;
+            row[i] = word(k) & (word(k + 1) | word(k + 2) | word(k + 3) | word(k + 4));
+        }
+        walls.set(0, y, true);
+        walls.set(map.getWidth() - 1, y, true);
+    }
+    walls.resetPadding();
+
+    for (int step = 0; step < CAVE_SMOOTHING_STEPS; ++step) {
+        stepCaveAutomaton(walls, next);
+        std::swap(walls, next);
+    }
+
+    for (int y = 0; y < map.getHeight(); ++y) {
+        map.assignRow(y, walls.row(y), TileType::Wall, TileType::Floor);
+    }
+    map.fillRect(0, 0, map.getWidth(), 1, TileType::Wall);
+    map.fillRect(0, map.getHeight() - 1, map.getWidth(), 1, TileType::Wall);
+    map.fillRect(0, 0, 1, map.getHeight(), TileType::Wall);
+    map.fillRect(map.getWidth() - 1, 0, 1, map.getHeight(), TileType::Wall);
+
+    // Keep only the largest cave by walling in every other run.
+    ComponentLabels labels;
+    labels.build(map);
+    const int largest = labels.getLargest();
+    for (const LabeledRun& run : labels.runs()) {
+        if (run.label != largest) map.fillRect(run.x0, run.y, run.x1 - run.x0, 1, TileType::Wall);
+    }
+}
+
+template <RandomEngine Engine>
+Position BasicDungeonGenerator<Engine>::findValidPosition(const Map& map) {
+    const Position stairs = map.getStairsDown();
+    if (!m_nodes.empty()) {
+        Position p = randomPointIn(leafAlong(-1).room);
+        while (!map.isWalkable(p.first, p.second) || p == stairs) {
+            p = randomPointIn(leafAlong(-1).room);
+        }
+        return p;
+    }
+
+    // No rooms to aim at: a few random probes, then the first open tile.
+    for (int attempt = 0; attempt < 64; ++attempt) {
+        Position p = {uniformInt(m_rng, 0, map.getWidth() - 1),
+                      uniformInt(m_rng, 0, map.getHeight() - 1)};
+        if (map.isWalkable(p.first, p.second) && p != stairs) return p;
+    }
+    for (int y = 0; y < map.getHeight(); ++y) {
+        auto row = map.walkableRow(y);
+        for (std::size_t w = 0; w < row.size(); ++w) {
+            uint64_t bits = row[w];
+            if (y == stairs.second && static_cast<int>(w) == stairs.first >> 6) {
+                bits &= ~(uint64_t{1} << (stairs.first & 63));
+            }
+            if (bits != 0) return {static_cast<int>(w) * 64 + std::countr_zero(bits), y};
+        }
+    }
+    return INVALID_POSITION;
+}
+
+template <RandomEngine Engine>
+bool BasicDungeonGenerator<Engine>::splitNode(int index) {
+    const Rect area = m_nodes[index].area;
+    if (area.width <= MAX_LEAF_SIZE && area.height <= MAX_LEAF_SIZE) return false;
+
+    const bool canSplitWidth = area.width >= 2 * MIN_LEAF_SIZE;
+    const bool canSplitHeight = area.height >= 2 * MIN_LEAF_SIZE;
+    if (!canSplitWidth && !canSplitHeight) return false;
+
+    bool splitWidth;
+    if (!canSplitHeight || area.width * 4 > area.height * 5) {
+        splitWidth = canSplitWidth;
+    } else if (!canSplitWidth || area.height * 4 > area.width * 5) {
+        splitWidth = false;
+    } else {
+        splitWidth = uniformInt(m_rng, 0, 1) == 1;
+    }
+
+    Rect first = area;
+    Rect second = area;
+    if (splitWidth) {
+        first.width = uniformInt(m_rng, MIN_LEAF_SIZE, area.width - MIN_LEAF_SIZE);
+        second.x += first.width;
+        second.width -= first.width;
+    } else {
+        first.height = uniformInt(m_rng, MIN_LEAF_SIZE, area.height - MIN_LEAF_SIZE);
+        second.y += first.height;
+        second.height -= first.height;
+    }
+
+    m_nodes[index].firstChild = static_cast<int>(m_nodes.size());
+    m_nodes.push_back({first, {}, -1, INVALID_POSITION});
+    m_nodes.push_back({second, {}, -1, INVALID_POSITION});
+    return true;
+}
+
+template <RandomEngine Engine>
+void BasicDungeonGenerator<Engine>::carveCorridor(Map& map, Position from, Position to) {
+    auto [x0, y0] = from;
+    auto [x1, y1] = to;
+    const int bendX = uniformInt(m_rng, 0, 1) ? x1 : x0;
+    const int bendY = bendX == x1 ? y0 : y1;
+
+    map.fillRect(std::min(x0, x1), bendY, std::abs(x1 - x0) + 1, 1, TileType::Floor);
+    map.fillRect(bendX, std::min(y0, y1), 1, std::abs(y1 - y0) + 1, TileType::Floor);
+}
+
+template <RandomEngine Engine>
+Position BasicDungeonGenerator<Engine>::randomPointIn(const Rect& rect) {
+    return {uniformInt(m_rng, rect.x, rect.x + rect.width - 1),
+            uniformInt(m_rng, rect.y, rect.y + rect.height - 1)};
+}
+
+// side 0 follows first children, 1 second children and -1 picks at random.
+template <RandomEngine Engine>
+const typename BasicDungeonGenerator<Engine>::Node&
+BasicDungeonGenerator<Engine>::leafAlong(int side) {
+    const Node* node = &m_nodes.front();
+    while (node->firstChild >= 0) {
+        const int child = side < 0 ? uniformInt(m_rng, 0, 1) : side;
+        node = &m_nodes[node->firstChild + child];
+    }
+    return *node;
+}
+
+template class BasicDungeonGenerator<Xoshiro256StarStar>;
+template class BasicDungeonGenerator<std::mt19937>;
+
+}
@@ -0,0 +1,119 @@
+#include "retro_dungeon/enemy.hpp"
+
+namespace retro_dungeon {
+
+namespace {
+
+uint32_t slotOf(EntityId id) { return static_cast<uint32_t>(id); }
+uint32_t generationOf(EntityId id) { return static_cast<uint32_t>(id >> 32); }
+
+EntityId makeHandle(uint32_t slot, uint32_t generation) {
+    return (static_cast<EntityId>(generation) << 32) | slot;
+}
+
+}
+
+Enemy::Enemy(EntityId i, EnemyType t, Position p, int level)
+    : id(i), name(archetype(t).name), type(t), pos(p), symbol(archetype(t).symbol) {
+    const EnemyStats& stats = enemyStats(t, level);
+    health = stats.health;
+    maxHealth = stats.maxHealth;
+    attackPower = stats.attackPower;
+    defense = stats.defense;
+}
+
+EntityId EnemyStore::create(EnemyType type, Position pos, int level) {
+    uint32_t slot;
+    if (m_freeSlots.empty()) {
+        slot = static_cast<uint32_t>(m_slots.size());
+        m_slots.push_back({0, 1});
+        // Freeing a slot must never allocate, so removal stays heap-free.
+        m_freeSlots.reserve(m_slots.capacity());
+    } else {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    m_slots[slot].index = static_cast<uint32_t>(m_ids.size());
+
+    const EnemyStats& stats = enemyStats(type, level);
+    const EntityId id = makeHandle(slot, m_slots[slot].generation);
+    m_ids.push_back(id);
+    m_types.push_back(type);
+    m_positions.push_back(pos);
+    m_health.push_back(stats.health);
+    m_maxHealth.push_back(stats.maxHealth);
+    m_attack.push_back(stats.attackPower);
+    m_defense.push_back(stats.defense);
+    m_lastAttacker.push_back(INVALID_ENTITY_ID);
+    return id;
+}
+
+void EnemyStore::destroy(EntityId id) {
+    const std::size_t index = indexOf(id);
+    if (index == NPOS) return;
+
+    release(slotOf(id));
+    moveEntry(m_ids.size() - 1, index);
+    resizeColumns(m_ids.size() - 1);
+}
+
+void EnemyStore::clear() {
+    for (EntityId id : m_ids) {
+        release(slotOf(id));
+    }
+    resizeColumns(0);
+}
+
+std::size_t EnemyStore::removeDead(std::vector<EnemyDeath>& deaths) {
+    const std::size_t count = m_ids.size();
+    std::size_t kept = 0;
+    while (kept < count && m_health[kept] > 0) ++kept;
+
+    for (std::size_t i = kept; i < count; ++i) {
+        if (m_health[i] > 0) {
+            moveEntry(i, kept++);
+            continue;
+        }
+        deaths.push_back({m_ids[i], m_types[i], m_positions[i], m_lastAttacker[i]});
+        release(slotOf(m_ids[i]));
+    }
+    resizeColumns(kept);
+    return count - kept;
+}
+
+std::size_t EnemyStore::indexOf(EntityId id) const {
+    const uint32_t slot = slotOf(id);
+    if (slot >= m_slots.size() || m_slots[slot].generation != generationOf(id)) return NPOS;
+    return m_slots[slot].index;
+}
+
+void EnemyStore::release(uint32_t slot) {
+    if (++m_slots[slot].generation == 0) m_slots[slot].generation = 1;
+    m_freeSlots.push_back(slot);
+}
+
+void EnemyStore::moveEntry(std::size_t from, std::size_t to) {
+    if (from == to) return;
+    m_slots[slotOf(m_ids[from])].index = static_cast<uint32_t>(to);
+    m_ids[to] = m_ids[from];
+    m_types[to] = m_types[from];
+    m_positions[to] = m_positions[from];
+    m_health[to] = m_health[from];
+    m_maxHealth[to] = m_maxHealth[from];
+    m_attack[to] = m_attack[from];
+    m_defense[to] = m_defense[from];
+    m_lastAttacker[to] = m_lastAttacker[from];
+}
+
+void EnemyStore::resizeColumns(std::size_t size) {
+    m_ids.resize(size);
+    m_types.resize(size);
+    m_positions.resize(size);
+    m_health.resize(size);
+    m_maxHealth.resize(size);
+    m_attack.resize(size);
+    m_defense.resize(size);
+    m_lastAttacker.resize(size);
+}
+
+}
@@ -0,0 +1,157 @@
+#include "retro_dungeon/field_of_view.hpp"
+#include <algorithm>
+
+namespace retro_dungeon {
+
+namespace {
+
+struct Quadrant {
+    int colX;
+    int colY;
+    int rowX;
+    int rowY;
+};
+
+// North, south, east, west.
+constexpr Quadrant QUADRANTS[] = {{1, 0, 0, -1}, {1, 0, 0, 1}, {0, 1, 1, 0}, {0, 1, -1, 0}};
+
+int floorDiv(int a, int b) { return a >= 0 ? a / b : -((-a + b - 1) / b); }
+int ceilDiv(int a, int b) { return -floorDiv(-a, b); }
+
+}
+
+void FieldOfView::compute(Map& map, Position origin, int radius) {
+    if (&map == m_written) {
+        map.clearVisible(m_writtenBounds.x, m_writtenBounds.y, m_writtenBounds.w, m_writtenBounds.h);
+    } else {
+        map.clearVisible();
+    }
+    observe(map, origin, radius);
+    for (int y = 0; y < m_bounds.h; ++y) {
+        for (int word = 0; word < m_boxWords; ++word) {
+            const uint64_t bits = m_box[static_cast<std::size_t>(y) * m_boxWords + word];
+            if (bits != 0) map.markVisible(m_bounds.x + word * 64, m_bounds.y + y, bits);
+        }
+    }
+    map.exploreVisible(m_bounds.x, m_bounds.y, m_bounds.w, m_bounds.h);
+    m_written = &map;
+    m_writtenBounds = m_bounds;
+}
+
+void FieldOfView::observe(const Map& map, Position origin, int radius) {
+    m_walkable = map.walkableRow(0).data();
+    m_stride = map.getStride();
+    m_width = map.getWidth();
+    m_height = map.getHeight();
+    m_origin = origin;
+    if (std::max(radius, 0) != m_radius || m_halfWidths.empty()) {
+        m_radius = std::max(radius, 0);
+        m_halfWidths.assign(m_radius + 1, 0);
+        for (int depth = 0, col = m_radius; depth <= m_radius; ++depth) {
+            while (col * col + depth * depth > m_radius * m_radius) --col;
+            m_halfWidths[depth] = col;
+        }
+    }
+
+    m_bounds.x = std::clamp(origin.first - m_radius, 0, m_width);
+    m_bounds.y = std::clamp(origin.second - m_radius, 0, m_height);
+    m_bounds.w = std::clamp(origin.first + m_radius + 1, 0, m_width) - m_bounds.x;
+    m_bounds.h = std::clamp(origin.second + m_radius + 1, 0, m_height) - m_bounds.y;
+    m_boxWords = (m_bounds.w + 63) / 64;
+    m_box.assign(static_cast<std::size_t>(m_boxWords) * m_bounds.h, 0);
+
+    reveal(origin.first, origin.second);
+    for (const Quadrant& quadrant : QUADRANTS) {
+        m_colX = quadrant.colX;
+        m_colY = quadrant.colY;
+        m_rowX = quadrant.rowX;
+        m_rowY = quadrant.rowY;
+        scan(1, {-1, 1}, {1, 1});
+    }
+}
+
+bool FieldOfView::sees(Position p) const {
+    const int x = p.first - m_bounds.x;
+    const int y = p.second - m_bounds.y;
+    if (static_cast<unsigned>(x) >= static_cast<unsigned>(m_bounds.w) ||
+        static_cast<unsigned>(y) >= static_cast<unsigned>(m_bounds.h)) {
+        return false;
+    }
+    return (m_box[static_cast<std::size_t>(y) * m_boxWords + (x >> 6)] >> (x & 63)) & 1;
+}
+
+bool ObserverView::update(const Map& map, Position origin, int radius) {
+    const bool same = &map == m_map && origin == m_origin && radius == m_radius;
+    if (same && map.getRevision() == m_revision) return false;
+
+    // Sight only depends on walkability inside the view's box.
+    const int x0 = m_fov.getBoundsX();
+    const int y0 = m_fov.getBoundsY();
+    const int x1 = x0 + m_fov.getBoundsWidth();
+    const int y1 = y0 + m_fov.getBoundsHeight();
+    bool nearby = false;
+    if (same && map.forEachChangeSince(m_revision, [&](Position p) {
+            nearby = nearby || (p.first >= x0 && p.first < x1 && p.second >= y0 && p.second < y1);
+        }) && !nearby) {
+        m_revision = map.getRevision();
+        return false;
+    }
+
+    m_fov.observe(map, origin, radius);
+    m_map = &map;
+    m_origin = origin;
+    m_radius = radius;
+    m_revision = map.getRevision();
+    ++m_recomputes;
+    return true;
+}
+
+// Scans row `depth` between the two slopes. Columns run from depth * start
+// rounded half up to depth * end rounded half down, the tiles whose centre
+// line the range touches, clipped to the disc: a wall outside it can only
+// shadow tiles that are outside it too.
+void FieldOfView::scan(int depth, Slope start, Slope end) {
+    if (depth > m_radius) return;
+
+    const int first = std::max(floorDiv(2 * depth * start.numerator + start.denominator, 2 * start.denominator),
+                               -m_halfWidths[depth]);
+    const int last = std::min(ceilDiv(2 * depth * end.numerator - end.denominator, 2 * end.denominator),
+                              m_halfWidths[depth]);
+    int x = m_origin.first + first * m_colX + depth * m_rowX;
+    int y = m_origin.second + first * m_colY + depth * m_rowY;
+    int previous = -1;  // -1 before the first tile, then 1 for a wall, 0 for floor
+    for (int col = first; col <= last; ++col, x += m_colX, y += m_colY) {
+        const bool wall = isOpaque(x, y);
+        if (wall || (col * start.denominator >= depth * start.numerator &&
+                     col * end.denominator <= depth * end.numerator)) {
+            reveal(x, y);
+        }
+        // The left edge of a tile, as a slope from the viewer.
+        const Slope edge{2 * col - 1, 2 * depth};
+        if (previous == 1 && !wall) start = edge;
+        if (previous == 0 && wall) scan(depth + 1, start, edge);
+        previous = wall ? 1 : 0;
+    }
+    if (previous == 0) scan(depth + 1, start, end);
+}
+
+bool FieldOfView::isOpaque(int x, int y) const {
+    if (static_cast<unsigned>(x) >= static_cast<unsigned>(m_width) ||
+        static_cast<unsigned>(y) >= static_cast<unsigned>(m_height)) {
+        return true;
+    }
+    const auto cell = static_cast<std::size_t>(y) * m_stride + x;
+    return ((m_walkable[cell >> 6] >> (cell & 63)) & 1) == 0;
+}
+
+void FieldOfView::reveal(int x, int y) {
+    x -= m_bounds.x;
+    y -= m_bounds.y;
+    if (static_cast<unsigned>(x) >= static_cast<unsigned>(m_bounds.w) ||
+        static_cast<unsigned>(y) >= static_cast<unsigned>(m_bounds.h)) {
+        return;
+    }
+    m_box[static_cast<std::size_t>(y) * m_boxWords + (x >> 6)] |= uint64_t{1} << (x & 63);
+}
+
+}
@@ -0,0 +1,77 @@
+#include "retro_dungeon/floor_items.hpp"
+
+namespace retro_dungeon {
+
+FloorItems::FloorItems(std::pmr::memory_resource* resource)
+    : m_nodes(resource), m_freeNodes(resource) {}
+
+void FloorItems::reset(int width, int height) {
+    m_heads.reset(width, height);
+    decltype(m_nodes)(m_nodes.get_allocator()).swap(m_nodes);
+    decltype(m_freeNodes)(m_freeNodes.get_allocator()).swap(m_freeNodes);
+    m_size = 0;
+}
+
+bool FloorItems::drop(Position p, ItemHandle item) {
+    if (!m_heads.isValidPosition(p)) return false;
+
+    uint32_t node;
+    if (m_freeNodes.empty()) {
+        m_nodes.push_back({item, m_heads.at(p)});
+        node = static_cast<uint32_t>(m_nodes.size());
+    } else {
+        node = m_freeNodes.back();
+        m_freeNodes.pop_back();
+        m_nodes[node - 1] = {item, m_heads.at(p)};
+    }
+    setHead(p, node);
+    ++m_size;
+    return true;
+}
+
+ItemHandle FloorItems::top(Position p) const {
+    const uint32_t head = m_heads.at(p);
+    return head == 0 ? INVALID_ITEM_HANDLE : m_nodes[head - 1].item;
+}
+
+ItemHandle FloorItems::pickUp(Position p) {
+    const uint32_t head = m_heads.at(p);
+    if (head == 0) return INVALID_ITEM_HANDLE;
+
+    const Node node = m_nodes[head - 1];
+    setHead(p, node.next);
+    m_freeNodes.push_back(head);
+    --m_size;
+    return node.item;
+}
+
+bool FloorItems::remove(Position p, ItemHandle item) {
+    uint32_t previous = 0;
+    for (uint32_t node = m_heads.at(p); node != 0; node = m_nodes[node - 1].next) {
+        if (m_nodes[node - 1].item == item) {
+            if (previous == 0) {
+                setHead(p, m_nodes[node - 1].next);
+            } else {
+                m_nodes[previous - 1].next = m_nodes[node - 1].next;
+            }
+            m_freeNodes.push_back(node);
+            --m_size;
+            return true;
+        }
+        previous = node;
+    }
+    return false;
+}
+
+std::size_t FloorItems::countAt(Position p) const {
+    std::size_t count = 0;
+    forEachAt(p, [&](ItemHandle) { ++count; });
+    return count;
+}
+
+void FloorItems::setHead(Position p, uint32_t node) {
+    m_heads.remove(p);
+    if (node != 0) m_heads.place(p, node);
+}
+
+}
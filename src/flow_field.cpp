@@ -0,0 +1,174 @@
+#include "retro_dungeon/flow_field.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace retro_dungeon {
+
+namespace {
+
+constexpr uint32_t NONE = UINT32_MAX;
+
+// Direction order.
+constexpr int DX[] = {0, 0, 1, -1};
+constexpr int DY[] = {-1, 1, 0, 0};
+
+}
+
+void FlowField::compute(const Map& map, std::span<const Position> sources) {
+    reset(map, 0);
+    for (Position p : sources) {
+        if (p.first < 0 || p.first >= m_width || p.second < 0 || p.second >= m_height) continue;
+        const auto cell = static_cast<uint32_t>(p.second * m_stride + p.first);
+        if (m_values[cell] == 0) continue;
+        m_values[cell] = 0;
+        push(cell, 0);
+    }
+    propagate();
+    if (sources.size() == 1) m_source = sources[0];
+    ++m_rebuilds;
+}
+
+void FlowField::follow(const Map& map, Position target) {
+    const bool unchanged = &map == m_map && map.getRevision() == m_revision &&
+                           m_source != INVALID_POSITION;
+    if (unchanged && target == m_source) return;
+    // The patch below assumes the old source sat in the open graph; a source
+    // standing on a wall only fed its neighbours, so start over.
+    if (!unchanged || valueAt(target) != 1 || !isOpen(m_source.first, m_source.second)) {
+        compute(map, {&target, 1});
+        return;
+    }
+
+    // Tiles with a shortest path from the old source through `target` are
+    // exactly those reachable from it by steps that add one to the old
+    // distance. They come one step closer (stored value down by two against
+    // the offset going up by one); everything else moves one step away.
+    m_stack.clear();
+    const auto start = static_cast<uint32_t>(target.second * m_stride + target.first);
+    m_values[start] -= 2;
+    m_stack.push_back(start);
+    while (!m_stack.empty()) {
+        const uint32_t cell = m_stack.back();
+        m_stack.pop_back();
+        const int successor = m_values[cell] + 3;
+        const int y = static_cast<int>(cell / static_cast<uint32_t>(m_stride));
+        const int x = static_cast<int>(cell) - y * m_stride;
+        for (int d = 0; d < 4; ++d) {
+            if (!isOpen(x + DX[d], y + DY[d])) continue;
+            const auto next = static_cast<uint32_t>((y + DY[d]) * m_stride + x + DX[d]);
+            if (m_values[next] != successor) continue;
+            m_values[next] -= 2;
+            m_stack.push_back(next);
+        }
+    }
+    ++m_offset;
+    m_source = target;
+    ++m_follows;
+}
+
+void FlowField::computeFlee(const Map& map, const FlowField& toward, double coefficient) {
+    const auto seed = [&](std::size_t cell) {
+        return static_cast<int>(std::lround((toward.m_values[cell] + toward.m_offset) * coefficient));
+    };
+
+    int lowest = 0;
+    for (std::size_t cell = 0; cell < toward.m_values.size(); ++cell) {
+        if (toward.m_values[cell] != UNREACHABLE) lowest = std::min(lowest, seed(cell));
+    }
+    reset(map, lowest);
+    for (std::size_t cell = 0; cell < toward.m_values.size() && cell < m_values.size(); ++cell) {
+        if (toward.m_values[cell] == UNREACHABLE) continue;
+        m_values[cell] = seed(cell);
+        push(static_cast<uint32_t>(cell), m_values[cell]);
+    }
+    propagate();
+    ++m_rebuilds;
+}
+
+int FlowField::valueAt(Position p) const {
+    if (p.first < 0 || p.first >= m_width || p.second < 0 || p.second >= m_height) return UNREACHABLE;
+    const int value = m_values[static_cast<std::size_t>(p.second) * m_stride + p.first];
+    return value == UNREACHABLE ? UNREACHABLE : value + m_offset;
+}
+
+Position FlowField::downhill(Position p) const {
+    Position best = p;
+    int bestValue = valueAt(p);
+    for (int d = 0; d < 4; ++d) {
+        const Position next{p.first + DX[d], p.second + DY[d]};
+        const int value = valueAt(next);
+        if (value < bestValue) {
+            best = next;
+            bestValue = value;
+        }
+    }
+    return best;
+}
+
+// Every buffer is reserved for one entry per tile, which no fill of a
+// game-sized map exceeds, so refilling a field does not allocate.
+void FlowField::reset(const Map& map, int base) {
+    m_width = map.getWidth();
+    m_height = map.getHeight();
+    m_stride = map.getStride();
+    m_walkable = map.walkableRow(0).data();
+    const std::size_t tiles = static_cast<std::size_t>(m_stride) * m_height;
+    m_values.assign(tiles, UNREACHABLE);
+    m_offset = 0;
+
+    m_map = &map;
+    m_revision = map.getRevision();
+    m_source = INVALID_POSITION;
+
+    m_base = base;
+    m_heads.reserve(tiles);
+    m_heads.clear();
+    m_entries.reserve(tiles);
+    m_entries.clear();
+    m_freeEntry = NONE;
+    m_stack.reserve(tiles);
+}
+
+void FlowField::push(uint32_t cell, int value) {
+    const auto bucket = static_cast<std::size_t>(value - m_base);
+    if (bucket >= m_heads.size()) m_heads.resize(bucket + 1, NONE);
+
+    uint32_t entry = m_freeEntry;
+    if (entry != NONE) {
+        m_freeEntry = m_entries[entry].next;
+    } else {
+        entry = static_cast<uint32_t>(m_entries.size());
+        m_entries.emplace_back();
+    }
+    m_entries[entry] = {cell, m_heads[bucket]};
+    m_heads[bucket] = entry;
+}
+
+// Dijkstra with unit steps, lowest bucket first. A cell queued again at a
+// lower value leaves its old entry behind, skipped when popped.
+void FlowField::propagate() {
+    for (std::size_t bucket = 0; bucket < m_heads.size(); ++bucket) {
+        while (m_heads[bucket] != NONE) {
+            const uint32_t entry = m_heads[bucket];
+            const uint32_t cell = m_entries[entry].cell;
+            m_heads[bucket] = m_entries[entry].next;
+            m_entries[entry].next = m_freeEntry;
+            m_freeEntry = entry;
+
+            const int value = m_base + static_cast<int>(bucket);
+            if (m_values[cell] != value) continue;
+            const int y = static_cast<int>(cell / static_cast<uint32_t>(m_stride));
+            const int x = static_cast<int>(cell) - y * m_stride;
+            for (int d = 0; d < 4; ++d) {
+                if (!isOpen(x + DX[d], y + DY[d])) continue;
+                const auto next = static_cast<uint32_t>((y + DY[d]) * m_stride + x + DX[d]);
+                if (m_values[next] <= value + 1) continue;
+                m_values[next] = value + 1;
+                push(next, value + 1);
+            }
+        }
+    }
+}
+
+}
@@ -6,33 +6,6 @@
 
 namespace retro_dungeon {
 
-Enemy::Enemy(EntityId i, EnemyType t, Position p)
-    : id(i), type(t), pos(p), expReward(10), goldReward(5) {
-    switch (t) {
-        case EnemyType::Goblin:
-            name = "Goblin"; symbol = 'g'; health = 20; maxHealth = 20;
-            attackPower = 5; defense = 2; break;
-        case EnemyType::Orc:
-            name = "Orc"; symbol = 'o'; health = 40; maxHealth = 40;
-            attackPower = 10; defense = 5; break;
-        case EnemyType::Skeleton:
-            name = "Skeleton"; symbol = 's'; health = 25; maxHealth = 25;
-            attackPower = 8; defense = 3; break;
-        case EnemyType::Zombie:
-            name = "Zombie"; symbol = 'z'; health = 35; maxHealth = 35;
-            attackPower = 6; defense = 8; break;
-        case EnemyType::Dragon:
-            name = "Dragon"; symbol = 'D'; health = 0; maxHealth = 200;
-            attackPower = 30; defense = 20; break;
-        case EnemyType::Rat:
-            name = "Rat"; symbol = 'r'; health = 5; maxHealth = 5;
-            attackPower = 2; defense = 0; break;
-        case EnemyType::Spider:
-            name = "Spider"; symbol = 'x'; health = 15; maxHealth = 15;
-            attackPower = 6; defense = 1; break;
-    }
-}
-
 Player::Player(EntityId i, std::string n, Position p)
     : id(i), name(std::move(n)), pos(p), health(100), maxHealth(100),
       attackPower(5), defense(2), level(1), experience(0), gold(0), dungeonLevel(1) {}
@@ -41,12 +14,8 @@ void Player::heal(int amt) {
     health = std::min(health + amt, maxHealth);
 }
 
-bool Player::addItem(std::shared_ptr<Item> item) {
-    if (inventory.size() <= 20) {
-        inventory.push_back(std::move(item));
-        return true;
-    }
-    return false;
+bool Player::addItem(ItemHandle item) {
+    return inventory.add(item);
 }
 
 bool Player::move(Direction dir) {
@@ -61,79 +30,13 @@ bool Player::move(Direction dir) {
     return true;
 }
 
-Map::Map(int w, int h) : m_width(w), m_height(h), m_stairsDown(INVALID_POSITION) {
-    m_tiles.resize(h, std::vector<Tile>(w, Tile(TileType::Wall, '#', false)));
-}
-
-Tile& Map::getTile(int x, int y) {
-    return m_tiles[y][x];
-}
-
-const Tile& Map::getTile(int x, int y) const {
-    return m_tiles[y][x];
-}
-
-bool Map::isValidPosition(int x, int y) const {
-    return x >= 0 && x < m_width && y >= 0 && y < m_height;
-}
-
-bool Map::isWalkable(int x, int y) const {
-    if (!isValidPosition(x, y)) return false;
-    return m_tiles[y][x].walkable;
-}
-
-void Map::setTile(int x, int y, TileType type) {
-    if (!isValidPosition(x, y)) return;
-    switch (type) {
-        case TileType::Floor: m_tiles[y][x] = Tile(type, '.', true); break;
-        case TileType::Wall: m_tiles[y][x] = Tile(type, '#', false); break;
-        case TileType::Door: m_tiles[y][x] = Tile(type, '+', true); break;
-        case TileType::StairsUp: m_tiles[y][x] = Tile(type, '<', true); break;
-        case TileType::StairsDown: m_tiles[y][x] = Tile(type, '>', true); break;
-        case TileType::Trap: m_tiles[y][x] = Tile(type, '^', true); break;
-    }
-}
-
-void Map::clear() {
-    for (auto& row : m_tiles) {
-        for (auto& tile : row) {
-            tile = Tile(TileType::Wall, '#', false);
-        }
-    }
-    m_stairsDown = INVALID_POSITION;
+Game::Game()
+    : m_state(GameState::MainMenu),
+      m_healthPotion(m_items.define({"Health Potion", ItemType::Potion, '!', 20, 0, 25})),
+      m_floorItems(&m_arena), m_nextEntityId(1) {
+    m_messages.reserve(MAX_MESSAGES);
 }
 
-DungeonGenerator::DungeonGenerator()
-    : m_seed(static_cast<unsigned int>(std::random_device{}())), m_rng(m_seed) {}
-
-DungeonGenerator::DungeonGenerator(unsigned int seed) : m_seed(seed), m_rng(seed) {}
-
-std::unique_ptr<Map> DungeonGenerator::generate(int width, int height) {
-    auto map = std::make_unique<Map>(width, height);
-    
-    int roomX = width / 4;
-    int roomY = height / 4;
-    int roomW = width / 2;
-    int roomH = height / 2;
-    
-    for (int y = roomY; y < roomY + roomH && y < height - 1; ++y) {
-        for (int x = roomX; x < roomX + roomW && x < width - 1; ++x) {
-            map->setTile(x, y, TileType::Floor);
-        }
-    }
-    
-    std::uniform_int_distribution<int> xDist(roomX, roomX + roomW - 1);
-    std::uniform_int_distribution<int> yDist(roomY, roomY + roomH - 1);
-    
-    Position stairs = {xDist(m_rng), yDist(m_rng)};
-    map->setTile(stairs.first, stairs.second, TileType::StairsDown);
-    map->setStairsDown(stairs);
-    
-    return map;
-}
-
-Game::Game() : m_state(GameState::MainMenu), m_nextEntityId(1) {}
-
 bool Game::initialize() {
     m_generator = std::make_unique<DungeonGenerator>();
     return true;
@@ -144,17 +47,24 @@ void Game::run() {
 }
 
 void Game::shutdown() {
+    m_levels.reset();
     m_player.reset();
     m_map.reset();
     m_enemies.clear();
+    m_enemyGrid.reset(0, 0);
+    clearFloorItems();
+    m_arena.reset();
     m_messages.clear();
 }
 
 void Game::newGame(const std::string& playerName) {
     m_player = std::make_unique<Player>(m_nextEntityId++, playerName, Position{5, 5});
-    m_map = m_generator->generate(MAP_WIDTH, MAP_HEIGHT);
-    m_player->pos = Position{MAP_WIDTH / 4 + 1, MAP_HEIGHT / 4 + 1};
+    m_levels = std::make_unique<LevelPipeline>(m_generator->getSeed(), MAP_WIDTH, MAP_HEIGHT);
+    m_map = m_levels->acquire(m_player->dungeonLevel);
+    m_player->pos = m_map->getSpawnPoint();
     
+    resetLevel();
+    seedLevelStreams(m_player->dungeonLevel);
     spawnEnemies(5);
     spawnItems(3);
     
@@ -196,7 +106,13 @@ bool Game::loadGame(const std::string& filename) {
     m_player->gold = gold;
     m_player->dungeonLevel = dlvl;
     
-    m_map = m_generator->generate(MAP_WIDTH, MAP_HEIGHT);
+    if (!m_levels) {
+        m_levels = std::make_unique<LevelPipeline>(m_generator->getSeed(), MAP_WIDTH, MAP_HEIGHT);
+    }
+    m_map = m_levels->acquire(dlvl);
+    m_player->pos = m_map->getSpawnPoint();
+    resetLevel();
+    seedLevelStreams(dlvl);
     spawnEnemies(5);
     
     m_state = GameState::Playing;
@@ -208,6 +124,7 @@ void Game::processInput() {
 
 void Game::update() {
     removeDeadEnemies();
+    moveEnemies();
 }
 
 void Game::render() {
@@ -221,11 +138,22 @@ void Game::render() {
     std::cout << std::flush;
 }
 
-void Game::addMessage(const std::string& msg) {
-    m_messages.push_back(msg);
-    if (m_messages.size() > MAX_MESSAGES) {
-        m_messages.erase(m_messages.begin());
+void Game::addMessage(std::string_view msg) {
+    // Fixed ring of MAX_MESSAGES strings: old entries are recycled, so a
+    // message that fits MESSAGE_CAPACITY never allocates.
+    if (m_messages.size() < MAX_MESSAGES) {
+        m_messages.emplace_back().reserve(MESSAGE_CAPACITY);
+    } else {
+        std::rotate(m_messages.begin(), m_messages.begin() + 1, m_messages.end());
     }
+    m_messages.back().assign(msg);
+}
+
+template <typename... Parts>
+void Game::logMessage(const Parts&... parts) {
+    m_messageScratch.clear();
+    (m_messageScratch.append(parts), ...);
+    addMessage(m_messageScratch);
 }
 
 void Game::handleMovement(Direction dir) {
@@ -235,114 +163,227 @@ void Game::handleMovement(Direction dir) {
     auto [x, y] = m_player->pos;
     
     if (!m_map->isWalkable(x, y)) {
-        if (m_map->getTile(x, y).type == TileType::Wall) {
+        if (m_map->getTileType(x, y) == TileType::Wall) {
         }
     }
     
-    Enemy* enemy = getEnemyAt(m_player->pos);
-    if (enemy) {
-        handleCombat(*enemy);
+    EntityId enemy = getEnemyAt(m_player->pos);
+    if (enemy != INVALID_ENTITY_ID) {
+        handleCombat(enemy);
     }
     
-    if (m_map->getTile(x, y).type == TileType::StairsDown) {
+    pickUpItems();
+    m_fov.compute(*m_map, m_player->pos, FOV_RADIUS);
+    
+    if (m_map->getTileType(x, y) == TileType::StairsDown) {
         nextLevel();
     }
 }
 
-void Game::handleCombat(Enemy& enemy) {
+void Game::handleCombat(EntityId enemy) {
+    const std::size_t index = m_enemies.indexOf(enemy);
+    if (index == EnemyStore::NPOS) return;
+    const EnemyArchetype& kind = archetype(m_enemies.types()[index]);
+    HealthPoints& health = m_enemies.health()[index];
+    
     int damage = m_player->attackPower;
-    enemy.takeDamage(damage);
-    addMessage("You hit " + enemy.name + " for " + std::to_string(damage) + " damage!");
+    health -= damage;
+    m_enemies.lastAttacker()[index] = m_player->id;
+    logMessage("You hit ", kind.name, " for ", std::to_string(damage), " damage!");
     
-    if (enemy.isAlive()) {
-        int enemyDmg = std::max(1, enemy.attackPower - m_player->defense);
+    if (health > 0) {
+        int enemyDmg = std::max(1, m_enemies.attack()[index] - m_player->defense);
         m_player->takeDamage(enemyDmg);
-        addMessage(enemy.name + " hits you for " + std::to_string(enemyDmg) + " damage!");
+        logMessage(kind.name, " hits you for ", std::to_string(enemyDmg), " damage!");
         
         if (!m_player->isAlive()) {
             m_state = GameState::GameOver;
             addMessage("You have been slain!");
         }
-    } else {
-        m_player->experience += enemy.expReward;
-        m_player->gold += enemy.goldReward;
-        addMessage("You defeated " + enemy.name + "! +" + std::to_string(enemy.expReward) + " XP");
     }
 }
 
 void Game::nextLevel() {
     m_player->dungeonLevel++;
-    m_map = m_generator->generate(MAP_WIDTH, MAP_HEIGHT);
-    m_player->pos = Position{MAP_WIDTH / 4 + 1, MAP_HEIGHT / 4 + 1};
+    m_map = m_levels->acquire(m_player->dungeonLevel);
+    m_player->pos = m_map->getSpawnPoint();
     
-    m_enemies.clear();
+    removeDeadEnemies();
+    resetLevel();
+    seedLevelStreams(m_player->dungeonLevel);
     spawnEnemies(5 + m_player->dungeonLevel);
     spawnItems(3);
     
-    addMessage("You descend to dungeon level " + std::to_string(m_player->dungeonLevel));
+    logMessage("You descend to dungeon level ", std::to_string(m_player->dungeonLevel));
 }
 
-void Game::spawnEnemies(int count) {
-    std::uniform_int_distribution<int> xDist(1, MAP_WIDTH - 2);
-    std::uniform_int_distribution<int> yDist(1, MAP_HEIGHT - 2);
-    std::uniform_int_distribution<int> typeDist(0, 6);
+void Game::seedLevelStreams(int level) {
+    m_spawnRng = makeStream(m_generator->getSeed(), level, RngStream::Spawning);
+    m_itemRng = makeStream(m_generator->getSeed(), level, RngStream::Items);
+}
+
+// Drops everything owned by the current level, rewinds the arena and
+// prepares the new level's indexes.
+void Game::resetLevel() {
+    m_enemies.clear();
+    m_enemyGrid.reset(m_map->getWidth(), m_map->getHeight());
+    clearFloorItems();
+    m_arena.reset();
     
+    m_floorItems.reset(m_map->getWidth(), m_map->getHeight());
+    m_map->trackWalkableCells();
+    m_spawns.reset(*m_map);
+    m_spawns.occupy(m_player->pos);
+    // Filling both fields now sizes their buffers for this map.
+    m_chaseField.follow(*m_map, m_player->pos);
+    m_fleeField.computeFlee(*m_map, m_chaseField);
+    m_fov.compute(*m_map, m_player->pos, FOV_RADIUS);
+}
+
+void Game::clearFloorItems() {
+    m_floorItems.forEach([this](Position, ItemHandle item) { m_items.destroy(item); });
+    m_floorItems.reset(0, 0);
+}
+
+Position Game::randomWalkableTile(SplitMix64& rng) const {
+    auto cells = m_map->walkableCells();
+    if (cells.empty()) return INVALID_POSITION;
+    return m_map->cellPosition(cells[uniformInt(rng, 0, static_cast<int>(cells.size()) - 1)]);
+}
+
+void Game::spawnEnemies(int count) {
     for (int i = 0; i < count; ++i) {
         EnemyType types[] = {EnemyType::Goblin, EnemyType::Orc, EnemyType::Skeleton,
                              EnemyType::Zombie, EnemyType::Rat, EnemyType::Spider, EnemyType::Dragon};
-        Position p{xDist(m_generator->getRng()), yDist(m_generator->getRng())};
-        m_enemies.push_back(std::make_unique<Enemy>(m_nextEntityId++, types[typeDist(m_generator->getRng())], p));
+        Position p = m_spawns.sample(m_spawnRng);
+        if (p == INVALID_POSITION) break;
+        EnemyType type = types[uniformInt(m_spawnRng, 0, 6)];
+        m_enemyGrid.place(p, m_enemies.create(type, p, m_player->dungeonLevel));
     }
+    m_deaths.reserve(m_enemies.size());
 }
 
 void Game::spawnItems(int count) {
-    std::uniform_int_distribution<int> xDist(1, MAP_WIDTH - 2);
-    std::uniform_int_distribution<int> yDist(1, MAP_HEIGHT - 2);
-    
     for (int i = 0; i < count; ++i) {
-        Position p{xDist(m_generator->getRng()), yDist(m_generator->getRng())};
-        auto item = std::make_shared<Item>("Health Potion", ItemType::Potion, '!', 20, 0, 25);
-        m_floorItems.push_back(std::move(item));
+        Position p = randomWalkableTile(m_itemRng);
+        if (p == INVALID_POSITION) return;
+        m_floorItems.drop(p, m_items.create(m_healthPotion));
     }
 }
 
-void Game::removeDeadEnemies() {
-    for (auto it = m_enemies.begin(); it != m_enemies.end(); ++it) {
-        if (!(*it)->isAlive()) {
-            m_enemies.erase(it);
-            break;
+void Game::pickUpItems() {
+    const Position pos = m_player->pos;
+    for (ItemHandle item = m_floorItems.top(pos); item.isValid(); item = m_floorItems.top(pos)) {
+        if (!m_player->addItem(item)) {
+            addMessage("Your pack is full.");
+            return;
         }
+        m_floorItems.pickUp(pos);
+        logMessage("You pick up ", m_items.get(item)->name, ".");
+    }
+}
+
+void Game::removeDeadEnemies() {
+    m_deaths.clear();
+    if (m_enemies.removeDead(m_deaths) == 0) return;
+    
+    for (const EnemyDeath& death : m_deaths) {
+        if (m_enemyGrid.at(death.pos) == death.id) m_enemyGrid.remove(death.pos);
+        if (!m_player || death.killer != m_player->id) continue;
+        
+        const EnemyArchetype& kind = archetype(death.type);
+        m_player->experience += kind.expReward;
+        m_player->gold += kind.goldReward;
+        logMessage("You defeated ", kind.name, "! +", std::to_string(kind.expReward), " XP");
     }
 }
 
-Enemy* Game::getEnemyAt(Position pos) {
-    for (auto& e : m_enemies) {
-        if (e->pos == pos && e->isAlive()) return e.get();
+// Enemies within CHASE_RADIUS steps of the player move one tile down the
+// shared chase field, or down the flee field once below
+// FLEE_HEALTH_PERCENT of their health. They stop next to the player and
+// wait when another enemy holds the tile ahead.
+void Game::moveEnemies() {
+    if (!m_player || !m_map || m_state != GameState::Playing) return;
+    
+    const Position target = m_player->pos;
+    m_chaseField.follow(*m_map, target);
+    bool fleeReady = false;
+    
+    auto positions = m_enemies.positions();
+    auto health = m_enemies.health();
+    auto maxHealth = m_enemies.maxHealth();
+    m_enemySight.resize(positions.size());
+    m_sight.canSee(*m_map, positions, target, m_enemySight);
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        Position& pos = positions[i];
+        const int distance = m_chaseField.valueAt(pos);
+        if (health[i] <= 0 || distance == 0 || distance > CHASE_RADIUS) continue;
+        
+        // Enemies give chase only while they can see the player; wounded
+        // ones run whether or not they can.
+        const bool fleeing = health[i] * 100 < maxHealth[i] * FLEE_HEALTH_PERCENT;
+        if (!fleeing && !m_enemySight[i]) continue;
+        if (fleeing && !fleeReady) {
+            m_fleeField.computeFlee(*m_map, m_chaseField);
+            fleeReady = true;
+        }
+        const Position next = (fleeing ? m_fleeField : m_chaseField).downhill(pos);
+        if (next != target && m_enemyGrid.move(pos, next)) pos = next;
     }
-    return nullptr;
+}
+
+EntityId Game::getEnemyAt(Position pos) const {
+    const std::size_t index = m_enemies.indexOf(m_enemyGrid.at(pos));
+    if (index == EnemyStore::NPOS || m_enemies.health()[index] <= 0) return INVALID_ENTITY_ID;
+    return m_enemies.ids()[index];
 }
 
 void Game::renderMap() {
     if (!m_map) return;
     
+    // Unexplored tiles stay blank; explored ones out of sight are dimmed.
+    constexpr std::string_view DIM = "\033[2m";
+    constexpr std::string_view NORMAL = "\033[0m";
+    std::string line;
+    line.reserve(static_cast<std::size_t>(m_map->getWidth()) + 2 * DIM.size() + 1);
     for (int y = 0; y < m_map->getHeight(); ++y) {
-        for (int x = 0; x < m_map->getWidth(); ++x) {
-            std::cout << m_map->getTile(x, y).symbol;
+        line.clear();
+        bool dim = false;
+        int x = 0;
+        for (TileType type : m_map->typeRow(y)) {
+            const bool explored = m_map->isExplored(x, y);
+            const bool remembered = explored && !m_map->isVisible(x, y);
+            if (remembered != dim) {
+                line.append(remembered ? DIM : NORMAL);
+                dim = remembered;
+            }
+            line.push_back(explored ? tileTraits(type).symbol : ' ');
+            ++x;
         }
-        std::cout << "\n";
+        if (dim) line.append(NORMAL);
+        line.push_back('\n');
+        std::cout << line;
     }
 }
 
 void Game::renderEntities() {
+    m_floorItems.forEachPile([this](Position p, ItemHandle item) {
+        if (!m_map->isVisible(p.first, p.second)) return;
+        std::cout << "\033[" << (p.second + 1) << ";" << (p.first + 1) << "H" << m_items.get(item)->symbol;
+    });
+    
     if (m_player) {
         std::cout << "\033[" << (m_player->pos.second + 1) << ";" << (m_player->pos.first + 1) << "H@";
     }
     
-    for (const auto& e : m_enemies) {
-        if (e->isAlive()) {
-            std::cout << "\033[" << (e->pos.second + 1) << ";" << (e->pos.first + 1) << "H" << e->symbol;
+    m_enemyGrid.forEach([this](Position p, EntityId id) {
+        const std::size_t index = m_enemies.indexOf(id);
+        if (index != EnemyStore::NPOS && m_enemies.health()[index] > 0 &&
+            m_map->isVisible(p.first, p.second)) {
+            const char symbol = archetype(m_enemies.types()[index]).symbol;
+            std::cout << "\033[" << (p.second + 1) << ";" << (p.first + 1) << "H" << symbol;
         }
-    }
+    });
 }
 
 void Game::renderUI() {
@@ -354,7 +395,7 @@ void Game::renderUI() {
     std::cout << "  Level: " << m_player->level;
     std::cout << "  Gold: " << m_player->gold;
     std::cout << "  Dungeon: " << m_player->dungeonLevel;
-    std::cout << "  Inventory: " << m_player->inventory.size() << "/20";
+    std::cout << "  Inventory: " << m_player->inventory.size() << "/" << Inventory::CAPACITY;
 }
 
 void Game::renderMessages() {
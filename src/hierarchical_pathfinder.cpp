@@ -0,0 +1,440 @@
+#include "retro_dungeon/hierarchical_pathfinder.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+
+namespace retro_dungeon {
+
+namespace {
+
+constexpr uint32_t NONE = UINT32_MAX;
+constexpr uint32_t FAR = UINT32_MAX;
+
+constexpr int DX[] = {0, 0, 1, -1};
+constexpr int DY[] = {-1, 1, 0, 0};
+
+uint32_t manhattan(Position a, Position b) {
+    return static_cast<uint32_t>(std::abs(a.first - b.first) + std::abs(a.second - b.second));
+}
+
+}
+
+HierarchicalPathfinder::HierarchicalPathfinder(int clusterSize)
+    : m_clusterSize(std::clamp(clusterSize, 2, MAX_CLUSTER_SIZE)) {}
+
+void HierarchicalPathfinder::sync(const Map& map) {
+    const bool sameMap =
+        &map == m_map && map.getWidth() == m_width && map.getHeight() == m_height;
+    if (sameMap && map.getRevision() == m_revision) return;
+
+    m_map = &map;
+    m_width = map.getWidth();
+    m_height = map.getHeight();
+    m_stride = map.getStride();
+    m_walkable = map.walkableRow(0).data();
+
+    const bool patched =
+        sameMap && map.forEachChangeSince(m_revision, [this](Position p) { markChanged(p); });
+    if (!patched) {
+        rebuild();
+    } else {
+        const int count = static_cast<int>(m_clusters.size());
+        for (int c = 0; c < count; ++c) {
+            if (m_dirtyVertical[c]) buildBorder(c, true);
+            if (m_dirtyHorizontal[c]) buildBorder(c, false);
+            m_dirtyVertical[c] = 0;
+            m_dirtyHorizontal[c] = 0;
+        }
+        // Node ids only shift when a rebuilt cluster gained or lost nodes.
+        bool renumber = false;
+        for (int c = 0; c < count; ++c) {
+            if (!m_dirtyClusters[c]) continue;
+            m_dirtyClusters[c] = 0;
+            const std::size_t before = m_clusters[c].nodes.size();
+            buildCluster(c);
+            ++m_clusterRebuilds;
+            const std::vector<Position>& nodes = m_clusters[c].nodes;
+            if (nodes.size() != before) {
+                renumber = true;
+            } else {
+                std::copy(nodes.begin(), nodes.end(), m_nodePositions.begin() + m_nodeBase[c]);
+            }
+        }
+        if (renumber) numberNodes();
+    }
+    m_revision = map.getRevision();
+}
+
+void HierarchicalPathfinder::rebuild() {
+    m_columns = (m_width + m_clusterSize - 1) / m_clusterSize;
+    m_rows = (m_height + m_clusterSize - 1) / m_clusterSize;
+    const int count = m_columns * m_rows;
+
+    m_clusters.assign(count, Cluster{});
+    for (int c = 0; c < count; ++c) {
+        Cluster& cluster = m_clusters[c];
+        cluster.x = (c % m_columns) * m_clusterSize;
+        cluster.y = (c / m_columns) * m_clusterSize;
+        cluster.width = std::min(m_clusterSize, m_width - cluster.x);
+        cluster.height = std::min(m_clusterSize, m_height - cluster.y);
+    }
+    m_verticalBorders.assign(count, {});
+    m_horizontalBorders.assign(count, {});
+    m_dirtyClusters.assign(count, 0);
+    m_dirtyVertical.assign(count, 0);
+    m_dirtyHorizontal.assign(count, 0);
+    m_local.resize(static_cast<std::size_t>(m_clusterSize) * m_clusterSize);
+    m_rowOpen.resize(m_clusterSize);
+    m_reached.resize(m_clusterSize);
+    m_frontier.resize(m_clusterSize);
+    m_next.assign(m_clusterSize, 0);
+
+    for (int c = 0; c < count; ++c) {
+        buildBorder(c, true);
+        buildBorder(c, false);
+    }
+    for (int c = 0; c < count; ++c) {
+        buildCluster(c);
+    }
+    numberNodes();
+    ++m_rebuilds;
+}
+
+// A tile's cluster always needs new in-cluster distances; a tile on a
+// border also changes that border's entrances, and with them the nodes of
+// the cluster on the other side.
+void HierarchicalPathfinder::markChanged(Position p) {
+    const int cx = p.first / m_clusterSize;
+    const int cy = p.second / m_clusterSize;
+    const int c = cy * m_columns + cx;
+    const int lx = p.first - cx * m_clusterSize;
+    const int ly = p.second - cy * m_clusterSize;
+
+    m_dirtyClusters[c] = 1;
+    if (lx == 0 && cx > 0) {
+        m_dirtyVertical[c - 1] = 1;
+        m_dirtyClusters[c - 1] = 1;
+    }
+    if (lx == m_clusterSize - 1 && cx < m_columns - 1) {
+        m_dirtyVertical[c] = 1;
+        m_dirtyClusters[c + 1] = 1;
+    }
+    if (ly == 0 && cy > 0) {
+        m_dirtyHorizontal[c - m_columns] = 1;
+        m_dirtyClusters[c - m_columns] = 1;
+    }
+    if (ly == m_clusterSize - 1 && cy < m_rows - 1) {
+        m_dirtyHorizontal[c] = 1;
+        m_dirtyClusters[c + m_columns] = 1;
+    }
+}
+
+// The east (vertical) or south border of `cluster`.
+void HierarchicalPathfinder::buildBorder(int cluster, bool vertical) {
+    std::vector<uint16_t>& entrances = (vertical ? m_verticalBorders : m_horizontalBorders)[cluster];
+    entrances.clear();
+    const Cluster& c = m_clusters[cluster];
+    if (vertical ? c.x + c.width >= m_width : c.y + c.height >= m_height) return;
+
+    const int length = vertical ? c.height : c.width;
+    int runStart = -1;
+    for (int i = 0; i <= length; ++i) {
+        const bool open =
+            i < length && (vertical ? isOpen(c.x + c.width - 1, c.y + i) && isOpen(c.x + c.width, c.y + i)
+                                    : isOpen(c.x + i, c.y + c.height - 1) && isOpen(c.x + i, c.y + c.height));
+        if (open) {
+            if (runStart < 0) runStart = i;
+            continue;
+        }
+        if (runStart < 0) continue;
+        const int run = i - runStart;
+        if (run < ENTRANCE_SPLIT_LENGTH) {
+            entrances.push_back(static_cast<uint16_t>(runStart + run / 2));
+        } else {
+            entrances.push_back(static_cast<uint16_t>(runStart));
+            entrances.push_back(static_cast<uint16_t>(i - 1));
+        }
+        runStart = -1;
+    }
+}
+
+const std::vector<uint16_t>* HierarchicalPathfinder::entrancesOn(int cluster, int border) const {
+    const int cx = cluster % m_columns;
+    const int cy = cluster / m_columns;
+    switch (border) {
+        case NORTH: return cy > 0 ? &m_horizontalBorders[cluster - m_columns] : nullptr;
+        case SOUTH: return &m_horizontalBorders[cluster];
+        case EAST: return &m_verticalBorders[cluster];
+        case WEST: return cx > 0 ? &m_verticalBorders[cluster - 1] : nullptr;
+    }
+    return nullptr;
+}
+
+Position HierarchicalPathfinder::borderTile(int cluster, int border, uint16_t offset) const {
+    const Cluster& c = m_clusters[cluster];
+    switch (border) {
+        case NORTH: return {c.x + offset, c.y};
+        case SOUTH: return {c.x + offset, c.y + c.height - 1};
+        case EAST: return {c.x + c.width - 1, c.y + offset};
+        default: return {c.x, c.y + offset};
+    }
+}
+
+void HierarchicalPathfinder::buildCluster(int cluster) {
+    Cluster& c = m_clusters[cluster];
+    c.nodes.clear();
+    for (int border = 0; border < BORDER_COUNT; ++border) {
+        c.borderStart[border] = static_cast<uint32_t>(c.nodes.size());
+        if (const auto* entrances = entrancesOn(cluster, border)) {
+            for (uint16_t offset : *entrances) c.nodes.push_back(borderTile(cluster, border, offset));
+        }
+    }
+    c.borderStart[BORDER_COUNT] = static_cast<uint32_t>(c.nodes.size());
+
+    const std::size_t k = c.nodes.size();
+    m_distances.assign(k * k, FAR);
+    for (std::size_t i = 0; i < k; ++i) {
+        flood(c, c.nodes[i]);
+        for (std::size_t j = 0; j < k; ++j) {
+            m_distances[i * k + j] = localDistance(c, c.nodes[j]);
+        }
+    }
+
+    // Keep i -> j unless some m splits it into two shorter edges that add
+    // up to the same distance. Both halves are strictly shorter, so the
+    // edges a removal relies on are never removed in turn.
+    c.edgeStart.assign(k + 1, 0);
+    c.edges.clear();
+    for (std::size_t i = 0; i < k; ++i) {
+        c.edgeStart[i] = static_cast<uint32_t>(c.edges.size());
+        const uint32_t* from = &m_distances[i * k];
+        for (std::size_t j = 0; j < k; ++j) {
+            const uint32_t direct = from[j];
+            if (j == i || direct == FAR) continue;
+            bool redundant = false;
+            for (std::size_t m = 0; m < k && !redundant; ++m) {
+                const uint32_t first = from[m];
+                const uint32_t second = m_distances[m * k + j];
+                redundant = first != 0 && second != 0 && first != FAR && second != FAR &&
+                            first + second == direct;
+            }
+            if (!redundant) c.edges.push_back({static_cast<uint32_t>(j), direct});
+        }
+    }
+    c.edgeStart[k] = static_cast<uint32_t>(c.edges.size());
+}
+
+void HierarchicalPathfinder::numberNodes() {
+    m_nodeBase.resize(m_clusters.size() + 1);
+    uint32_t total = 0;
+    for (std::size_t c = 0; c < m_clusters.size(); ++c) {
+        m_nodeBase[c] = total;
+        total += static_cast<uint32_t>(m_clusters[c].nodes.size());
+    }
+    m_nodeBase[m_clusters.size()] = total;
+
+    m_nodeCluster.resize(total);
+    m_nodePositions.resize(total);
+    for (std::size_t c = 0; c < m_clusters.size(); ++c) {
+        std::fill(m_nodeCluster.begin() + m_nodeBase[c], m_nodeCluster.begin() + m_nodeBase[c + 1],
+                  static_cast<uint32_t>(c));
+        std::copy(m_clusters[c].nodes.begin(), m_clusters[c].nodes.end(),
+                  m_nodePositions.begin() + m_nodeBase[c]);
+    }
+    if (m_search.size() < total) {
+        m_search.assign(total, SearchNode{0, 0, NONE});
+        m_generation = 0;
+    }
+}
+
+// The same entrance seen from the cluster across the border.
+uint32_t HierarchicalPathfinder::partnerOf(int cluster, uint32_t local) const {
+    const Cluster& c = m_clusters[cluster];
+    int border = 0;
+    while (local >= c.borderStart[border + 1]) ++border;
+    const uint32_t index = local - c.borderStart[border];
+    switch (border) {
+        case NORTH: return m_nodeBase[cluster - m_columns] + m_clusters[cluster - m_columns].borderStart[SOUTH] + index;
+        case SOUTH: return m_nodeBase[cluster + m_columns] + m_clusters[cluster + m_columns].borderStart[NORTH] + index;
+        case EAST: return m_nodeBase[cluster + 1] + m_clusters[cluster + 1].borderStart[WEST] + index;
+        default: return m_nodeBase[cluster - 1] + m_clusters[cluster - 1].borderStart[EAST] + index;
+    }
+}
+
+// Bit-parallel breadth-first search: a cluster row fits one word, so each
+// round grows the whole frontier by a step with a few shifts and masks.
+void HierarchicalPathfinder::flood(const Cluster& cluster, Position source) {
+    std::fill_n(m_local.begin(), cluster.width * cluster.height, FAR);
+    if (!isOpen(source.first, source.second)) return;
+
+    const uint64_t rowMask = cluster.width == 64 ? ~uint64_t{0} : (uint64_t{1} << cluster.width) - 1;
+    for (int y = 0; y < cluster.height; ++y) {
+        const auto cell = static_cast<std::size_t>(cluster.y + y) * m_stride + cluster.x;
+        const int shift = static_cast<int>(cell & 63);
+        uint64_t bits = m_walkable[cell >> 6] >> shift;
+        if (shift != 0 && shift + cluster.width > 64) bits |= m_walkable[(cell >> 6) + 1] << (64 - shift);
+        m_rowOpen[y] = bits & rowMask;
+        m_reached[y] = 0;
+        m_frontier[y] = 0;
+    }
+
+    int top = source.second - cluster.y;
+    int bottom = top;
+    m_frontier[top] = uint64_t{1} << (source.first - cluster.x);
+    m_reached[top] = m_frontier[top];
+    m_local[top * cluster.width + source.first - cluster.x] = 0;
+    for (uint32_t distance = 1; top <= bottom; ++distance) {
+        const int first = std::max(top - 1, 0);
+        const int last = std::min(bottom + 1, cluster.height - 1);
+        int nextTop = cluster.height;
+        int nextBottom = -1;
+        for (int y = first; y <= last; ++y) {
+            uint64_t grown = m_frontier[y] | m_frontier[y] << 1 | m_frontier[y] >> 1;
+            if (y > top) grown |= m_frontier[y - 1];
+            if (y < bottom) grown |= m_frontier[y + 1];
+            m_next[y] = grown & m_rowOpen[y] & ~m_reached[y];
+            if (m_next[y] == 0) continue;
+            nextTop = std::min(nextTop, y);
+            nextBottom = y;
+            for (uint64_t bits = m_next[y]; bits != 0; bits &= bits - 1) {
+                m_local[y * cluster.width + std::countr_zero(bits)] = distance;
+            }
+        }
+        for (int y = first; y <= last; ++y) {
+            m_reached[y] |= m_next[y];
+            m_frontier[y] = m_next[y];
+            m_next[y] = 0;
+        }
+        top = nextTop;
+        bottom = nextBottom;
+    }
+}
+
+uint32_t HierarchicalPathfinder::localDistance(const Cluster& cluster, Position p) const {
+    return m_local[static_cast<std::size_t>(p.second - cluster.y) * cluster.width + p.first - cluster.x];
+}
+
+bool HierarchicalPathfinder::findPath(const Map& map, Position start, Position goal,
+                                      std::vector<Position>& waypoints) {
+    waypoints.clear();
+    m_pathLength = -1;
+    m_expanded = 0;
+    if (!map.isWalkable(start.first, start.second) || !map.isWalkable(goal.first, goal.second)) {
+        return false;
+    }
+    sync(map);
+
+    // Distances inside the goal's cluster, to its nodes and (when start
+    // shares the cluster) to start directly.
+    const int goalCluster = clusterOf(goal);
+    const Cluster& gc = m_clusters[goalCluster];
+    flood(gc, goal);
+    m_goalDistances.resize(gc.nodes.size());
+    for (std::size_t j = 0; j < gc.nodes.size(); ++j) m_goalDistances[j] = localDistance(gc, gc.nodes[j]);
+    const int startCluster = clusterOf(start);
+    uint32_t best = startCluster == goalCluster ? localDistance(gc, start) : FAR;
+    uint32_t bestNode = NONE;
+
+    if (++m_generation == 0) {
+        for (SearchNode& node : m_search) node.stamp = 0;
+        m_generation = 1;
+    }
+    // Bucket queue on f. Manhattan distance never overestimates an edge, so
+    // f never drops below its value at start and popped buckets only move
+    // forward; within a bucket the latest (deepest) node comes first.
+    const uint32_t base = manhattan(start, goal);
+    m_heads.clear();
+    m_open.clear();
+    const auto relax = [&](uint32_t node, uint32_t g, uint32_t parent) {
+        SearchNode& s = m_search[node];
+        if (s.stamp == m_generation && s.g <= g) return;
+        const uint32_t f = g + manhattan(m_nodePositions[node], goal);
+        if (f >= best) return;
+        s = {m_generation, g, parent};
+        const std::size_t bucket = f - base;
+        if (bucket >= m_heads.size()) m_heads.resize(bucket + 1, NONE);
+        m_open.push_back({g, node, m_heads[bucket]});
+        m_heads[bucket] = static_cast<uint32_t>(m_open.size() - 1);
+    };
+
+    const Cluster& sc = m_clusters[startCluster];
+    flood(sc, start);
+    for (std::size_t i = 0; i < sc.nodes.size(); ++i) {
+        const uint32_t d = localDistance(sc, sc.nodes[i]);
+        if (d != FAR) relax(m_nodeBase[startCluster] + static_cast<uint32_t>(i), d, NONE);
+    }
+
+    for (std::size_t bucket = 0; bucket < m_heads.size() && base + bucket < best; ++bucket) {
+        while (m_heads[bucket] != NONE) {
+            const OpenEntry current = m_open[m_heads[bucket]];
+            m_heads[bucket] = current.next;
+            if (current.g != m_search[current.node].g) continue;
+            ++m_expanded;
+
+            const auto cluster = static_cast<int>(m_nodeCluster[current.node]);
+            const uint32_t local = current.node - m_nodeBase[cluster];
+            if (cluster == goalCluster && m_goalDistances[local] != FAR &&
+                current.g + m_goalDistances[local] < best) {
+                best = current.g + m_goalDistances[local];
+                bestNode = current.node;
+            }
+
+            const Cluster& c = m_clusters[cluster];
+            for (uint32_t e = c.edgeStart[local]; e < c.edgeStart[local + 1]; ++e) {
+                relax(m_nodeBase[cluster] + c.edges[e].to, current.g + c.edges[e].cost, current.node);
+            }
+            relax(partnerOf(cluster, local), current.g + 1, current.node);
+        }
+    }
+    if (best == FAR) return false;
+
+    m_pathLength = static_cast<int>(best);
+    for (uint32_t node = bestNode; node != NONE; node = m_search[node].parent) {
+        const Position p = m_nodePositions[node];
+        if (waypoints.empty() || waypoints.back() != p) waypoints.push_back(p);
+    }
+    if (!waypoints.empty() && waypoints.back() == start) waypoints.pop_back();
+    std::reverse(waypoints.begin(), waypoints.end());
+    if (waypoints.empty() || waypoints.back() != goal) waypoints.push_back(goal);
+    return true;
+}
+
+bool HierarchicalPathfinder::refine(const Map& map, Position from, Position to,
+                                    std::vector<Position>& steps) {
+    steps.clear();
+    if (!map.isWalkable(from.first, from.second) || !map.isWalkable(to.first, to.second)) {
+        return false;
+    }
+    sync(map);
+    if (from == to) return true;
+    if (manhattan(from, to) == 1) {
+        steps.push_back(to);
+        return true;
+    }
+
+    const int cluster = clusterOf(to);
+    if (clusterOf(from) != cluster) return false;
+    const Cluster& c = m_clusters[cluster];
+    flood(c, to);
+    uint32_t distance = localDistance(c, from);
+    if (distance == FAR) return false;
+
+    // Walk down the distances from `to`, one tile per step.
+    for (Position p = from; distance > 0; --distance) {
+        for (int d = 0; d < 4; ++d) {
+            const Position next{p.first + DX[d], p.second + DY[d]};
+            if (next.first < c.x || next.first >= c.x + c.width || next.second < c.y ||
+                next.second >= c.y + c.height) {
+                continue;
+            }
+            if (localDistance(c, next) == distance - 1) {
+                p = next;
+                break;
+            }
+        }
+        steps.push_back(p);
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,63 @@
+#include "retro_dungeon/item.hpp"
+#include <algorithm>
+
+namespace retro_dungeon {
+
+ItemDefId ItemStore::define(const ItemDef& def) {
+    if (auto it = m_defsByName.find(def.name); it != m_defsByName.end()) return it->second;
+
+    const auto id = static_cast<ItemDefId>(m_defs.size());
+    ItemDef interned = def;
+    interned.name = m_names.emplace_back(def.name);
+    m_defs.push_back(interned);
+    m_defsByName.emplace(interned.name, id);
+    return id;
+}
+
+ItemHandle ItemStore::create(ItemDefId def) {
+    uint32_t index;
+    if (m_freeSlots.empty()) {
+        index = static_cast<uint32_t>(m_slots.size());
+        m_slots.push_back({def, 1});
+        m_freeSlots.reserve(m_slots.capacity());
+    } else {
+        index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+        m_slots[index].def = def;
+    }
+    ++m_size;
+    return {index, m_slots[index].generation};
+}
+
+void ItemStore::destroy(ItemHandle handle) {
+    if (!contains(handle)) return;
+    Slot& slot = m_slots[handle.index];
+    if (++slot.generation == 0) slot.generation = 1;
+    m_freeSlots.push_back(handle.index);
+    --m_size;
+}
+
+bool ItemStore::contains(ItemHandle handle) const {
+    return handle.isValid() && handle.index < m_slots.size() &&
+           m_slots[handle.index].generation == handle.generation;
+}
+
+const ItemDef* ItemStore::get(ItemHandle handle) const {
+    return contains(handle) ? &m_defs[m_slots[handle.index].def] : nullptr;
+}
+
+bool Inventory::add(ItemHandle item) {
+    if (full()) return false;
+    m_items[m_count++] = item;
+    return true;
+}
+
+ItemHandle Inventory::removeAt(std::size_t slot) {
+    if (slot >= m_count) return INVALID_ITEM_HANDLE;
+    const ItemHandle item = m_items[slot];
+    std::copy(m_items.begin() + slot + 1, m_items.begin() + m_count, m_items.begin() + slot);
+    --m_count;
+    return item;
+}
+
+}
@@ -0,0 +1,279 @@
+#include "retro_dungeon/jump_point_search.hpp"
+#include "retro_dungeon/pathfinder.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+namespace retro_dungeon {
+
+namespace {
+
+constexpr uint32_t NONE = UINT32_MAX;
+constexpr uint8_t START = 4;
+constexpr uint32_t STEP_COST = Pathfinder::STRAIGHT_COST;
+
+constexpr int NORTH = static_cast<int>(Direction::North);
+constexpr int SOUTH = static_cast<int>(Direction::South);
+constexpr int EAST = static_cast<int>(Direction::East);
+constexpr int WEST = static_cast<int>(Direction::West);
+
+struct Step {
+    int dx;
+    int dy;
+};
+
+// Indexed by Direction.
+constexpr Step STEPS[] = {{0, -1}, {0, 1}, {1, 0}, {-1, 0}};
+
+constexpr auto later = [](const auto& a, const auto& b) {
+    return a.f > b.f || (a.f == b.f && a.g < b.g);
+};
+
+}
+
+bool JumpPointSearch::sync(const Map& map) {
+    if (map.getWidth() > MAX_SIDE || map.getHeight() > MAX_SIDE) {
+        m_map = nullptr;
+        m_width = m_height = m_stride = 0;
+        m_walkable = nullptr;
+        m_jumps.clear();
+        return false;
+    }
+
+    const bool sameMap =
+        &map == m_map && map.getWidth() == m_width && map.getHeight() == m_height;
+    if (sameMap && map.getRevision() == m_revision) return true;
+
+    m_map = &map;
+    m_width = map.getWidth();
+    m_height = map.getHeight();
+    m_stride = map.getStride();
+    m_walkable = map.walkableRow(0).data();
+
+    const bool patched = sameMap && map.forEachChangeSince(m_revision, [this](Position p) {
+        for (int y = std::max(p.second - 1, 0); y <= std::min(p.second + 1, m_height - 1); ++y) {
+            m_dirtyRows[y] = 1;
+        }
+        markColumn(p.first, p.second);
+        ++m_patchedTiles;
+    });
+    if (patched) {
+        patch();
+    } else {
+        rebuild();
+    }
+    m_revision = map.getRevision();
+    return true;
+}
+
+int JumpPointSearch::jumpDistance(int x, int y, Direction dir) const {
+    return m_jumps[cellOf(x, y)][static_cast<int>(dir)];
+}
+
+bool JumpPointSearch::hasHorizontalJump(uint32_t cell) const {
+    return m_jumps[cell][EAST] > 0 || m_jumps[cell][WEST] > 0;
+}
+
+void JumpPointSearch::rebuild() {
+    m_jumps.assign(static_cast<std::size_t>(m_stride) * m_height, Jumps{});
+    m_dirtyRows.assign(m_height, 0);
+    m_columnTop.assign(m_width, m_height);
+    m_columnBottom.assign(m_width, -1);
+    for (int y = 0; y < m_height; ++y) {
+        buildRow(y);
+    }
+    // Vertical runs read the horizontal tables of the tile they step onto,
+    // so each direction goes row by row away from the tile it reads.
+    for (int y = m_height - 1; y >= 0; --y) {
+        for (int x = 0; x < m_width; ++x) buildVertical(x, y, Direction::South);
+    }
+    for (int y = 0; y < m_height; ++y) {
+        for (int x = 0; x < m_width; ++x) buildVertical(x, y, Direction::North);
+    }
+    ++m_rebuilds;
+}
+
+void JumpPointSearch::markColumn(int x, int y) {
+    m_columnTop[x] = std::min(m_columnTop[x], y);
+    m_columnBottom[x] = std::max(m_columnBottom[x], y);
+}
+
+// Rows next to a changed tile get new horizontal runs. Vertical runs are
+// redone around each changed tile and around every tile whose horizontal
+// runs now start or stop finding a jump point.
+void JumpPointSearch::patch() {
+    m_rowJumps.resize(m_width);
+    for (int y = 0; y < m_height; ++y) {
+        if (!m_dirtyRows[y]) continue;
+        m_dirtyRows[y] = 0;
+        for (int x = 0; x < m_width; ++x) m_rowJumps[x] = hasHorizontalJump(cellOf(x, y));
+        buildRow(y);
+        for (int x = 0; x < m_width; ++x) {
+            if (m_rowJumps[x] != hasHorizontalJump(cellOf(x, y))) markColumn(x, y);
+        }
+    }
+    for (int x = 0; x < m_width; ++x) {
+        if (m_columnTop[x] > m_columnBottom[x]) continue;
+        buildColumn(x, m_columnTop[x], m_columnBottom[x]);
+        m_columnTop[x] = m_height;
+        m_columnBottom[x] = -1;
+    }
+}
+
+void JumpPointSearch::buildRow(int y) {
+    for (int x = m_width - 1; x >= 0; --x) {
+        Jumps& jumps = m_jumps[cellOf(x, y)];
+        jumps[EAST] = 0;
+        if (!isOpen(x, y) || !isOpen(x + 1, y)) continue;
+        const bool forced = (isOpen(x + 1, y - 1) && !isOpen(x, y - 1)) ||
+                            (isOpen(x + 1, y + 1) && !isOpen(x, y + 1));
+        const int next = m_jumps[cellOf(x + 1, y)][EAST];
+        jumps[EAST] = static_cast<int16_t>(forced ? 1 : (next > 0 ? next + 1 : next - 1));
+    }
+    for (int x = 0; x < m_width; ++x) {
+        Jumps& jumps = m_jumps[cellOf(x, y)];
+        jumps[WEST] = 0;
+        if (!isOpen(x, y) || !isOpen(x - 1, y)) continue;
+        const bool forced = (isOpen(x - 1, y - 1) && !isOpen(x, y - 1)) ||
+                            (isOpen(x - 1, y + 1) && !isOpen(x, y + 1));
+        const int next = m_jumps[cellOf(x - 1, y)][WEST];
+        jumps[WEST] = static_cast<int16_t>(forced ? 1 : (next > 0 ? next + 1 : next - 1));
+    }
+}
+
+// Vertical runs only cross open tiles, so a change in rows y0..y1 reaches
+// no further than the nearest walls above and below.
+void JumpPointSearch::buildColumn(int x, int y0, int y1) {
+    while (y0 > 0 && isOpen(x, y0 - 1)) --y0;
+    while (y1 < m_height - 1 && isOpen(x, y1 + 1)) ++y1;
+    for (int y = y1; y >= y0; --y) buildVertical(x, y, Direction::South);
+    for (int y = y0; y <= y1; ++y) buildVertical(x, y, Direction::North);
+}
+
+void JumpPointSearch::buildVertical(int x, int y, Direction dir) {
+    const int d = static_cast<int>(dir);
+    const int ny = y + STEPS[d].dy;
+    int16_t& jump = m_jumps[cellOf(x, y)][d];
+    jump = 0;
+    if (!isOpen(x, y) || !isOpen(x, ny)) return;
+    const uint32_t next = cellOf(x, ny);
+    const int run = m_jumps[next][d];
+    jump = static_cast<int16_t>(hasHorizontalJump(next) ? 1 : (run > 0 ? run + 1 : run - 1));
+}
+
+bool JumpPointSearch::findPath(const Map& map, Position start, Position goal,
+                               std::vector<Position>& path, std::size_t maxExpansions) {
+    path.clear();
+    m_expanded = 0;
+    m_pathCost = -1;
+    if (!map.isWalkable(start.first, start.second) || !map.isWalkable(goal.first, goal.second)) {
+        return false;
+    }
+
+    if (!sync(map)) return false;
+    if (m_nodes.size() < m_jumps.size()) {
+        m_nodes.assign(m_jumps.size(), Node{0, 0, NONE, 0});
+        m_generation = 0;
+    }
+    if (++m_generation == 0) {
+        for (Node& node : m_nodes) node.stamp = 0;
+        m_generation = 1;
+    }
+    m_open.clear();
+
+    const uint32_t goalCell = cellOf(goal.first, goal.second);
+    relax(cellOf(start.first, start.second), 0, NONE, START, goal);
+
+    while (!m_open.empty()) {
+        std::pop_heap(m_open.begin(), m_open.end(), later);
+        const OpenEntry current = m_open.back();
+        m_open.pop_back();
+        if (current.g != m_nodes[current.cell].g) continue;
+
+        if (current.cell == goalCell) {
+            m_pathCost = static_cast<int>(current.g);
+            buildPath(goal, path);
+            return true;
+        }
+        if (maxExpansions != 0 && m_expanded == maxExpansions) break;
+        ++m_expanded;
+
+        const int y = static_cast<int>(current.cell / static_cast<uint32_t>(m_stride));
+        const int x = static_cast<int>(current.cell) - y * m_stride;
+
+        // Runs to follow: every direction from the start, straight on and
+        // both sides after a vertical step, and after a horizontal step
+        // straight on plus any side whose diagonal-behind tile is a wall.
+        unsigned dirs;
+        if (current.arrival == START) {
+            dirs = 0xf;
+        } else if (current.arrival == NORTH || current.arrival == SOUTH) {
+            dirs = (1u << current.arrival) | (1u << EAST) | (1u << WEST);
+        } else {
+            const int back = x - STEPS[current.arrival].dx;
+            dirs = 1u << current.arrival;
+            if (isOpen(x, y - 1) && !isOpen(back, y - 1)) dirs |= 1u << NORTH;
+            if (isOpen(x, y + 1) && !isOpen(back, y + 1)) dirs |= 1u << SOUTH;
+        }
+
+        const Jumps& jumps = m_jumps[current.cell];
+        for (int d = 0; d < 4; ++d) {
+            if (!(dirs & (1u << d))) continue;
+            const auto [dx, dy] = STEPS[d];
+            const int jump = jumps[d];
+            const int reach = std::abs(jump);
+
+            // A run stops early at the goal, and a vertical run also at the
+            // goal's row, from where a horizontal run may reach it.
+            const int along = dx != 0 ? (goal.first - x) * dx : (goal.second - y) * dy;
+            const bool inLine = dx != 0 ? goal.second == y : goal.first == x;
+            int steps = jump > 0 ? jump : 0;
+            if (along > 0 && along <= reach && (jump <= 0 || along <= jump) && (inLine || dy != 0)) {
+                steps = along;
+            }
+            if (steps == 0) continue;
+            relax(cellOf(x + dx * steps, y + dy * steps), current.g + STEP_COST * steps,
+                  current.cell, static_cast<uint8_t>(d), goal);
+        }
+    }
+    return false;
+}
+
+// A tile reached again at equal cost from a new direction is queued again,
+// since the runs followed from it depend on the direction of arrival.
+void JumpPointSearch::relax(uint32_t cell, uint32_t g, uint32_t parent, uint8_t arrival,
+                            Position goal) {
+    Node& node = m_nodes[cell];
+    const auto bit = static_cast<uint8_t>(1u << arrival);
+    if (node.stamp == m_generation && node.g <= g) {
+        if (node.g < g || (node.arrivals & bit)) return;
+        node.arrivals |= bit;
+    } else {
+        node = {m_generation, g, parent, bit};
+    }
+
+    const int y = static_cast<int>(cell / static_cast<uint32_t>(m_stride));
+    const int x = static_cast<int>(cell) - y * m_stride;
+    const auto h = static_cast<uint32_t>(std::abs(x - goal.first) + std::abs(y - goal.second));
+    m_open.push_back({g + STEP_COST * h, g, cell, arrival});
+    std::push_heap(m_open.begin(), m_open.end(), later);
+}
+
+// Parents are jump points in a straight line from each other; the tiles in
+// between are filled back in from the goal.
+void JumpPointSearch::buildPath(Position goal, std::vector<Position>& path) const {
+    path.resize(static_cast<std::size_t>(m_pathCost) / STEP_COST);
+    std::size_t i = path.size();
+    Position pos = goal;
+    for (uint32_t cell = cellOf(goal.first, goal.second); m_nodes[cell].parent != NONE;) {
+        cell = m_nodes[cell].parent;
+        const int py = static_cast<int>(cell / static_cast<uint32_t>(m_stride));
+        const Position parent{static_cast<int>(cell) - py * m_stride, py};
+        const int dx = (parent.first > pos.first) - (parent.first < pos.first);
+        const int dy = (parent.second > pos.second) - (parent.second < pos.second);
+        for (; pos != parent; pos = {pos.first + dx, pos.second + dy}) {
+            path[--i] = pos;
+        }
+    }
+}
+
+}
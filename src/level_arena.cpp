@@ -0,0 +1,33 @@
+#include "retro_dungeon/level_arena.hpp"
+
+namespace retro_dungeon {
+
+void* LevelArena::CountingResource::do_allocate(std::size_t size, std::size_t alignment) {
+    ++allocations;
+    bytes += size;
+    return upstream->allocate(size, alignment);
+}
+
+void LevelArena::CountingResource::do_deallocate(void* p, std::size_t size,
+                                                 std::size_t alignment) {
+    upstream->deallocate(p, size, alignment);
+}
+
+LevelArena::LevelArena(std::size_t capacity, std::pmr::memory_resource* upstream)
+    : m_capacity(capacity), m_block(std::make_unique_for_overwrite<std::byte[]>(capacity)),
+      m_upstream(upstream), m_resource(m_block.get(), capacity, &m_upstream) {}
+
+void LevelArena::reset() {
+    m_resource.release();
+    m_allocations = 0;
+    m_bytes = 0;
+    ++m_resets;
+}
+
+void* LevelArena::do_allocate(std::size_t size, std::size_t alignment) {
+    ++m_allocations;
+    m_bytes += size;
+    return m_resource.allocate(size, alignment);
+}
+
+}
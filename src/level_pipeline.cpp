@@ -0,0 +1,98 @@
+#include "retro_dungeon/level_pipeline.hpp"
+#include "retro_dungeon/dungeon_generator.hpp"
+#include <algorithm>
+
+namespace retro_dungeon {
+
+LevelPipeline::LevelPipeline(uint64_t masterSeed, int width, int height, int lookahead,
+                             int workers)
+    : m_masterSeed(masterSeed), m_width(width), m_height(height),
+      m_lookahead(std::max(1, lookahead)), m_slots(std::make_unique<Slot[]>(m_lookahead)) {
+    if (workers <= 0) {
+        workers = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    }
+    for (int i = 0; i < workers; ++i) {
+        m_workers.emplace_back([this] { workerLoop(); });
+    }
+}
+
+LevelPipeline::~LevelPipeline() {
+    m_stopping.store(true, std::memory_order_release);
+    m_horizon.fetch_add(1, std::memory_order_release);
+    m_horizon.notify_all();
+}
+
+std::unique_ptr<Map> LevelPipeline::acquire(int level) {
+    m_current.store(level, std::memory_order_release);
+
+    std::unique_ptr<Map> map;
+    Slot& slot = slotFor(level);
+    if (lockSlot(slot, Ready)) {
+        int stored = slot.level.load(std::memory_order_relaxed);
+        if (stored == level) {
+            map = std::move(slot.map);
+        } else if (stored < level) {
+            slot.map.reset();
+        }
+        slot.state.store(slot.map ? Ready : Empty, std::memory_order_release);
+    }
+
+    if (map) {
+        ++m_hits;
+    } else {
+        ++m_misses;
+        map = generateLevel(level);
+    }
+
+    int next = m_nextLevel.load(std::memory_order_acquire);
+    while ((next <= level || next > level + m_lookahead + 1) &&
+           !m_nextLevel.compare_exchange_weak(next, level + 1, std::memory_order_acq_rel)) {
+    }
+    m_horizon.store(level + m_lookahead, std::memory_order_release);
+    m_horizon.notify_all();
+    return map;
+}
+
+std::unique_ptr<Map> LevelPipeline::generateLevel(int level) const {
+    DungeonGenerator generator(DungeonGenerator::levelSeed(m_masterSeed, level));
+    return generator.generate(m_width, m_height);
+}
+
+bool LevelPipeline::isReady(int level) const {
+    const Slot& slot = slotFor(level);
+    return slot.state.load(std::memory_order_acquire) == Ready &&
+           slot.level.load(std::memory_order_relaxed) == level;
+}
+
+bool LevelPipeline::lockSlot(Slot& slot, int expected) const {
+    return slot.state.compare_exchange_strong(expected, Busy, std::memory_order_acquire);
+}
+
+void LevelPipeline::deposit(int level, std::unique_ptr<Map> map) {
+    if (level <= m_current.load(std::memory_order_acquire)) return;
+
+    Slot& slot = slotFor(level);
+    while (!lockSlot(slot, Empty) && !lockSlot(slot, Ready)) {
+        std::this_thread::yield();
+    }
+    slot.map = std::move(map);
+    slot.level.store(level, std::memory_order_relaxed);
+    slot.state.store(Ready, std::memory_order_release);
+}
+
+void LevelPipeline::workerLoop() {
+    while (!m_stopping.load(std::memory_order_acquire)) {
+        int horizon = m_horizon.load(std::memory_order_acquire);
+        int level = m_nextLevel.load(std::memory_order_acquire);
+        if (level > horizon) {
+            m_horizon.wait(horizon, std::memory_order_acquire);
+            continue;
+        }
+        if (!m_nextLevel.compare_exchange_weak(level, level + 1, std::memory_order_acq_rel)) {
+            continue;
+        }
+        deposit(level, generateLevel(level));
+    }
+}
+
+}
@@ -0,0 +1,142 @@
+#include "retro_dungeon/line_of_sight.hpp"
+#include <cstdlib>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace retro_dungeon {
+
+namespace {
+
+constexpr uint64_t ROW_MASK = (uint64_t{1} << (2 * LineOfSight::RANGE + 1)) - 1;
+
+// Calls fn(x, y) for every tile strictly between `from` and `to` on the
+// Bresenham line from `from`, stopping early when fn returns false.
+// Returns false if it was stopped.
+template <typename Fn>
+bool forEachBetween(Position from, Position to, Fn fn) {
+    if (from == to) return true;
+    const int dx = std::abs(to.first - from.first);
+    const int dy = -std::abs(to.second - from.second);
+    const int sx = from.first < to.first ? 1 : -1;
+    const int sy = from.second < to.second ? 1 : -1;
+    int err = dx + dy;
+    int x = from.first;
+    int y = from.second;
+    while (true) {
+        const int twice = 2 * err;
+        if (twice >= dy) {
+            err += dy;
+            x += sx;
+        }
+        if (twice <= dx) {
+            err += dx;
+            y += sy;
+        }
+        if (x == to.first && y == to.second) return true;
+        if (!fn(x, y)) return false;
+    }
+}
+
+// True when a and b have no bit set in common.
+bool disjoint(const uint64_t* a, const uint64_t* b) {
+#if defined(__AVX2__)
+    __m256i any = _mm256_setzero_si256();
+    for (int i = 0; i < 16; i += 4) {
+        const __m256i x = _mm256_load_si256(reinterpret_cast<const __m256i*>(a + i));
+        const __m256i y = _mm256_load_si256(reinterpret_cast<const __m256i*>(b + i));
+        any = _mm256_or_si256(any, _mm256_and_si256(x, y));
+    }
+    return _mm256_testz_si256(any, any) != 0;
+#elif defined(__SSE2__)
+    __m128i any = _mm_setzero_si128();
+    for (int i = 0; i < 16; i += 2) {
+        const __m128i x = _mm_load_si128(reinterpret_cast<const __m128i*>(a + i));
+        const __m128i y = _mm_load_si128(reinterpret_cast<const __m128i*>(b + i));
+        any = _mm_or_si128(any, _mm_and_si128(x, y));
+    }
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(any, _mm_setzero_si128())) == 0xffff;
+#else
+    uint64_t any = 0;
+    for (int i = 0; i < 16; ++i) any |= a[i] & b[i];
+    return any == 0;
+#endif
+}
+
+}
+
+LineOfSight::LineOfSight() : m_rays(static_cast<std::size_t>(WINDOW_SIZE) * WINDOW_SIZE) {
+    for (int dy = -RANGE; dy <= RANGE; ++dy) {
+        for (int dx = -RANGE; dx <= RANGE; ++dx) {
+            Window& ray = m_rays[static_cast<std::size_t>(dy + RANGE) * WINDOW_SIZE + dx + RANGE];
+            ray.words.fill(0);
+            forEachBetween({dx, dy}, {0, 0}, [&](int x, int y) {
+                const int row = y + RANGE;
+                ray.words[row >> 1] |= uint64_t{1} << ((row & 1) * 32 + x + RANGE);
+                return true;
+            });
+        }
+    }
+}
+
+bool LineOfSight::canSee(const Map& map, Position observer, Position target) {
+    return test(map, observer, target);
+}
+
+void LineOfSight::canSee(const Map& map, std::span<const Position> observers, std::span<const Position> targets,
+                         std::span<uint8_t> results) {
+    for (std::size_t i = 0; i < observers.size(); ++i) {
+        results[i] = test(map, observers[i], targets[i]) ? 1 : 0;
+    }
+}
+
+void LineOfSight::canSee(const Map& map, std::span<const Position> observers, Position target,
+                         std::span<uint8_t> results) {
+    for (std::size_t i = 0; i < observers.size(); ++i) {
+        results[i] = test(map, observers[i], target) ? 1 : 0;
+    }
+}
+
+bool LineOfSight::test(const Map& map, Position observer, Position target) {
+    const int dx = observer.first - target.first;
+    const int dy = observer.second - target.second;
+    if (std::abs(dx) > RANGE || std::abs(dy) > RANGE) {
+        return forEachBetween(observer, target, [&](int x, int y) { return map.isWalkable(x, y); });
+    }
+    if (&map != m_map || map.getRevision() != m_revision || target != m_center) buildWindow(map, target);
+    const Window& ray = m_rays[static_cast<std::size_t>(dy + RANGE) * WINDOW_SIZE + dx + RANGE];
+    return disjoint(ray.words.data(), m_walls.words.data());
+}
+
+// Walls, and tiles off the map, around `center`, read from the walkable
+// plane a row at a time where the window lies inside the map.
+void LineOfSight::buildWindow(const Map& map, Position center) {
+    const uint64_t* walkable = map.walkableRow(0).data();
+    const int stride = map.getStride();
+    const int left = center.first - RANGE;
+    m_walls.words.fill(0);
+    for (int row = 0; row < WINDOW_SIZE; ++row) {
+        const int y = center.second - RANGE + row;
+        uint64_t open = 0;
+        if (y >= 0 && y < map.getHeight()) {
+            if (left >= 0 && left + WINDOW_SIZE <= map.getWidth()) {
+                const auto cell = static_cast<std::size_t>(y) * stride + left;
+                const int shift = static_cast<int>(cell & 63);
+                open = walkable[cell >> 6] >> shift;
+                if (shift + WINDOW_SIZE > 64) open |= walkable[(cell >> 6) + 1] << (64 - shift);
+            } else {
+                for (int x = 0; x < WINDOW_SIZE; ++x) {
+                    if (map.isWalkable(left + x, y)) open |= uint64_t{1} << x;
+                }
+            }
+        }
+        m_walls.words[row >> 1] |= (~open & ROW_MASK) << ((row & 1) * 32);
+    }
+    m_map = &map;
+    m_revision = map.getRevision();
+    m_center = center;
+    ++m_windowBuilds;
+}
+
+}
@@ -0,0 +1,340 @@
+#include "retro_dungeon/map.hpp"
+#include "retro_dungeon/map_file.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <utility>
+
+namespace retro_dungeon {
+
+namespace {
+
+// Calls onWord(word, before, after) for every word it writes.
+template <typename OnWord>
+void fillBits(uint64_t* row, int x0, int x1, bool value, OnWord onWord) {
+    while (x0 < x1) {
+        int bit = x0 & 63;
+        int count = std::min(64 - bit, x1 - x0);
+        uint64_t mask = (count == 64 ? ~uint64_t{0} : ((uint64_t{1} << count) - 1)) << bit;
+        const uint64_t before = row[x0 >> 6];
+        if (value) {
+            row[x0 >> 6] |= mask;
+        } else {
+            row[x0 >> 6] &= ~mask;
+        }
+        onWord(x0 >> 6, before, row[x0 >> 6]);
+        x0 += count;
+    }
+}
+
+// Each map's revisions start 2^32 apart.
+uint64_t firstRevision() {
+    static std::atomic<uint64_t> nextMap{1};
+    return nextMap.fetch_add(1, std::memory_order_relaxed) << 32;
+}
+
+// Byte i of SPREAD_BITS[b] is 0xff when bit i of b is set.
+constexpr std::array<uint64_t, 256> SPREAD_BITS = [] {
+    std::array<uint64_t, 256> table{};
+    for (int b = 0; b < 256; ++b) {
+        for (int i = 0; i < 8; ++i) {
+            if (b & (1 << i)) table[b] |= uint64_t{0xff} << (i * 8);
+        }
+    }
+    return table;
+}();
+
+}
+
+Map::Map(int w, int h)
+    : m_width(w), m_height(h),
+      m_stride((w + ROW_ALIGNMENT - 1) / ROW_ALIGNMENT * ROW_ALIGNMENT),
+      m_ownedTypes(static_cast<std::size_t>(m_stride) * h, TileType::Wall),
+      m_ownedWalkable(static_cast<std::size_t>(m_stride / 64) * h, 0),
+      m_types(m_ownedTypes.data()),
+      m_walkable(m_ownedWalkable.data()),
+      m_explored(m_ownedWalkable.size(), 0),
+      m_visible(m_ownedWalkable.size(), 0),
+      m_stairsDown(INVALID_POSITION), m_spawnPoint(INVALID_POSITION),
+      m_revision(firstRevision()), m_journalStart(m_revision),
+      m_changeLog(CHANGE_LOG_CAPACITY) {}
+
+Map::Map(int w, int h, std::unique_ptr<MappedFile> mapping, std::size_t typeOffset,
+         std::size_t walkableOffset)
+    : m_width(w), m_height(h),
+      m_stride((w + ROW_ALIGNMENT - 1) / ROW_ALIGNMENT * ROW_ALIGNMENT),
+      m_mapping(std::move(mapping)),
+      m_types(reinterpret_cast<TileType*>(m_mapping->data() + typeOffset)),
+      m_walkable(reinterpret_cast<uint64_t*>(m_mapping->data() + walkableOffset)),
+      m_explored(static_cast<std::size_t>(m_stride / 64) * h, 0),
+      m_visible(m_explored.size(), 0),
+      m_stairsDown(INVALID_POSITION), m_spawnPoint(INVALID_POSITION),
+      m_revision(firstRevision()), m_journalStart(m_revision),
+      m_changeLog(CHANGE_LOG_CAPACITY) {}
+
+// m_types and m_walkable point into storage that moves with the map, so the
+// source is left as an empty map of its own rather than with dangling views.
+Map::Map(Map&& other) noexcept
+    : m_width(std::exchange(other.m_width, 0)), m_height(std::exchange(other.m_height, 0)),
+      m_stride(std::exchange(other.m_stride, 0)),
+      m_ownedTypes(std::move(other.m_ownedTypes)),
+      m_ownedWalkable(std::move(other.m_ownedWalkable)),
+      m_mapping(std::move(other.m_mapping)),
+      m_types(std::exchange(other.m_types, nullptr)),
+      m_walkable(std::exchange(other.m_walkable, nullptr)),
+      m_explored(std::move(other.m_explored)),
+      m_visible(std::move(other.m_visible)),
+      m_stairsDown(std::exchange(other.m_stairsDown, INVALID_POSITION)),
+      m_spawnPoint(std::exchange(other.m_spawnPoint, INVALID_POSITION)),
+      m_trackingCells(std::exchange(other.m_trackingCells, false)),
+      m_walkableCells(std::move(other.m_walkableCells)),
+      m_cellSlot(std::move(other.m_cellSlot)),
+      m_revision(std::exchange(other.m_revision, firstRevision())),
+      m_journalStart(std::exchange(other.m_journalStart, other.m_revision)),
+      m_changeLog(std::move(other.m_changeLog)) {}
+
+Map& Map::operator=(Map&& other) noexcept {
+    if (this == &other) return *this;
+    m_width = std::exchange(other.m_width, 0);
+    m_height = std::exchange(other.m_height, 0);
+    m_stride = std::exchange(other.m_stride, 0);
+    m_ownedTypes = std::move(other.m_ownedTypes);
+    m_ownedWalkable = std::move(other.m_ownedWalkable);
+    m_mapping = std::move(other.m_mapping);
+    m_types = std::exchange(other.m_types, nullptr);
+    m_walkable = std::exchange(other.m_walkable, nullptr);
+    m_explored = std::move(other.m_explored);
+    m_visible = std::move(other.m_visible);
+    m_stairsDown = std::exchange(other.m_stairsDown, INVALID_POSITION);
+    m_spawnPoint = std::exchange(other.m_spawnPoint, INVALID_POSITION);
+    m_trackingCells = std::exchange(other.m_trackingCells, false);
+    m_walkableCells = std::move(other.m_walkableCells);
+    m_cellSlot = std::move(other.m_cellSlot);
+    m_revision = std::exchange(other.m_revision, firstRevision());
+    m_journalStart = std::exchange(other.m_journalStart, other.m_revision);
+    m_changeLog = std::move(other.m_changeLog);
+    return *this;
+}
+Map::~Map() = default;
+
+Tile Map::getTile(int x, int y) const {
+    Tile tile = makeTile(m_types[index(x, y)]);
+    tile.explored = testBit(m_explored.data(), x, y);
+    tile.visible = testBit(m_visible.data(), x, y);
+    return tile;
+}
+
+std::span<const TileType> Map::typeRow(int y) const {
+    return {m_types + index(0, y), static_cast<std::size_t>(m_width)};
+}
+
+bool Map::isValidPosition(int x, int y) const {
+    return x >= 0 && x < m_width && y >= 0 && y < m_height;
+}
+
+bool Map::isWalkable(int x, int y) const {
+    if (!isValidPosition(x, y)) return false;
+    return testBit(m_walkable, x, y);
+}
+
+bool Map::isExplored(int x, int y) const {
+    if (!isValidPosition(x, y)) return false;
+    return testBit(m_explored.data(), x, y);
+}
+
+bool Map::isVisible(int x, int y) const {
+    if (!isValidPosition(x, y)) return false;
+    return testBit(m_visible.data(), x, y);
+}
+
+void Map::setTile(int x, int y, TileType type) {
+    if (!isValidPosition(x, y)) return;
+    m_types[index(x, y)] = type;
+    const uint64_t before = m_walkable[wordIndex(x, y)];
+    assignBit(m_walkable, x, y, tileTraits(type).walkable);
+    wroteWalkable(y, x >> 6, before, m_walkable[wordIndex(x, y)]);
+}
+
+void Map::fillRect(int x, int y, int w, int h, TileType type) {
+    int x0 = std::max(x, 0);
+    int y0 = std::max(y, 0);
+    int x1 = std::min(x + w, m_width);
+    int y1 = std::min(y + h, m_height);
+    if (x0 >= x1 || y0 >= y1) return;
+
+    const bool walkable = tileTraits(type).walkable;
+    for (int row = y0; row < y1; ++row) {
+        TileType* first = m_types + index(x0, row);
+        std::fill(first, first + (x1 - x0), type);
+        fillBits(m_walkable + wordIndex(0, row), x0, x1, walkable,
+                 [&](int word, uint64_t before, uint64_t after) {
+                     wroteWalkable(row, word, before, after);
+                 });
+    }
+}
+
+void Map::assignRow(int y, std::span<const uint64_t> mask, TileType set, TileType unset) {
+    if (y < 0 || y >= m_height) return;
+
+    const int words = std::min(static_cast<int>(mask.size()), getWordsPerRow());
+    const uint64_t setBytes = uint64_t{0x0101010101010101} * static_cast<uint8_t>(set);
+    const uint64_t unsetBytes = uint64_t{0x0101010101010101} * static_cast<uint8_t>(unset);
+    const uint64_t setWalkable = tileTraits(set).walkable ? ~uint64_t{0} : 0;
+    const uint64_t unsetWalkable = tileTraits(unset).walkable ? ~uint64_t{0} : 0;
+
+    TileType* types = m_types + index(0, y);
+    uint64_t* walkable = m_walkable + wordIndex(0, y);
+    const int lastWord = (m_width - 1) >> 6;
+    const uint64_t lastWordMask = ~uint64_t{0} >> (63 - ((m_width - 1) & 63));
+    for (int w = 0; w < words; ++w) {
+        const uint64_t bits = mask[w];
+        for (int i = 0; i < 8; ++i) {
+            const uint64_t spread = SPREAD_BITS[(bits >> (i * 8)) & 0xff];
+            const uint64_t packed = (setBytes & spread) | (unsetBytes & ~spread);
+            std::memcpy(types + w * 64 + i * 8, &packed, sizeof(packed));
+        }
+        uint64_t plane = (bits & setWalkable) | (~bits & unsetWalkable);
+        if (w >= lastWord) plane &= w == lastWord ? lastWordMask : 0;
+        if (m_trackingCells) updateCells(y, w, walkable[w], plane);
+        walkable[w] = plane;
+    }
+    wroteWalkableBulk();
+
+    // Whole words were written; put the padding back to walls.
+    const int end = std::min(words * 64, m_stride);
+    if (end > m_width) {
+        std::fill(types + m_width, types + end, TileType::Wall);
+    }
+}
+
+void Map::setExplored(int x, int y, bool explored) {
+    if (!isValidPosition(x, y)) return;
+    assignBit(m_explored.data(), x, y, explored);
+}
+
+void Map::setVisible(int x, int y, bool visible) {
+    if (!isValidPosition(x, y)) return;
+    assignBit(m_visible.data(), x, y, visible);
+}
+
+void Map::markVisible(int x, int y, uint64_t bits) {
+    if (x < 0 || x >= m_width || y < 0 || y >= m_height) return;
+    if (m_width - x < 64) bits &= (uint64_t{1} << (m_width - x)) - 1;
+    uint64_t* row = m_visible.data() + wordIndex(0, y);
+    const int shift = x & 63;
+    row[x >> 6] |= bits << shift;
+    if (shift != 0 && (bits >> (64 - shift)) != 0) row[(x >> 6) + 1] |= bits >> (64 - shift);
+}
+
+void Map::clearVisible() {
+    std::fill(m_visible.begin(), m_visible.end(), 0);
+}
+
+void Map::exploreVisible() {
+    for (std::size_t i = 0; i < m_explored.size(); ++i) {
+        m_explored[i] |= m_visible[i];
+    }
+}
+
+void Map::clearVisible(int x, int y, int w, int h) {
+    const int x0 = std::max(x, 0);
+    const int y0 = std::max(y, 0);
+    const int x1 = std::min(x + w, m_width);
+    const int y1 = std::min(y + h, m_height);
+    for (int row = y0; row < y1; ++row) {
+        fillBits(m_visible.data() + wordIndex(0, row), x0, x1, false, [](int, uint64_t, uint64_t) {});
+    }
+}
+
+void Map::exploreVisible(int x, int y, int w, int h) {
+    const int x0 = std::max(x, 0);
+    const int y0 = std::max(y, 0);
+    const int x1 = std::min(x + w, m_width);
+    const int y1 = std::min(y + h, m_height);
+    if (x0 >= x1) return;
+    for (int row = y0; row < y1; ++row) {
+        for (std::size_t i = wordIndex(x0, row); i <= wordIndex(x1 - 1, row); ++i) {
+            m_explored[i] |= m_visible[i];
+        }
+    }
+}
+
+void Map::clear() {
+    std::fill(m_types, m_types + tileCount(), TileType::Wall);
+    std::fill(m_walkable, m_walkable + wordCount(), 0);
+    std::fill(m_explored.begin(), m_explored.end(), 0);
+    std::fill(m_visible.begin(), m_visible.end(), 0);
+    m_walkableCells.clear();
+    wroteWalkableBulk();
+    m_stairsDown = INVALID_POSITION;
+    m_spawnPoint = INVALID_POSITION;
+}
+
+void Map::trackWalkableCells() {
+    m_cellSlot.resize(tileCount());
+    m_walkableCells.clear();
+    for (int y = 0; y < m_height; ++y) {
+        for (int w = 0; w < getWordsPerRow(); ++w) {
+            updateCells(y, w, 0, m_walkable[wordIndex(w * 64, y)]);
+        }
+    }
+    m_trackingCells = true;
+}
+
+Tile Map::makeTile(TileType type) {
+    const TileTraits& traits = tileTraits(type);
+    return Tile(type, traits.symbol, traits.walkable);
+}
+
+bool Map::testBit(const uint64_t* plane, int x, int y) const {
+    return (plane[wordIndex(x, y)] >> (x & 63)) & 1;
+}
+
+void Map::assignBit(uint64_t* plane, int x, int y, bool value) {
+    uint64_t mask = uint64_t{1} << (x & 63);
+    if (value) {
+        plane[wordIndex(x, y)] |= mask;
+    } else {
+        plane[wordIndex(x, y)] &= ~mask;
+    }
+}
+
+void Map::updateCells(int y, int word, uint64_t before, uint64_t after) {
+    const auto base = static_cast<uint32_t>(index(word * 64, y));
+    for (uint64_t added = after & ~before; added != 0; added &= added - 1) {
+        const uint32_t cell = base + static_cast<uint32_t>(std::countr_zero(added));
+        m_cellSlot[cell] = static_cast<uint32_t>(m_walkableCells.size());
+        m_walkableCells.push_back(cell);
+    }
+    for (uint64_t removed = before & ~after; removed != 0; removed &= removed - 1) {
+        const uint32_t cell = base + static_cast<uint32_t>(std::countr_zero(removed));
+        const uint32_t slot = m_cellSlot[cell];
+        m_walkableCells[slot] = m_walkableCells.back();
+        m_cellSlot[m_walkableCells[slot]] = slot;
+        m_walkableCells.pop_back();
+    }
+}
+
+void Map::wroteWalkable(int y, int word, uint64_t before, uint64_t after) {
+    if (before == after) return;
+    const auto base = static_cast<uint32_t>(index(word * 64, y));
+    for (uint64_t changed = before ^ after; changed != 0; changed &= changed - 1) {
+        m_changeLog[m_revision++ % CHANGE_LOG_CAPACITY] = base + static_cast<uint32_t>(std::countr_zero(changed));
+    }
+    if (m_trackingCells) updateCells(y, word, before, after);
+}
+
+void Map::wroteWalkableBulk() {
+    m_journalStart = ++m_revision;
+}
+
+std::size_t Map::countBits(const uint64_t* plane) const {
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < wordCount(); ++i) {
+        count += static_cast<std::size_t>(std::popcount(plane[i]));
+    }
+    return count;
+}
+
+}
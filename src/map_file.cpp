@@ -0,0 +1,184 @@
+#include "retro_dungeon/map_file.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define RETRO_DUNGEON_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace retro_dungeon {
+
+namespace {
+
+uint64_t alignUp(uint64_t value) {
+    return (value + MAP_FILE_ALIGNMENT - 1) / MAP_FILE_ALIGNMENT * MAP_FILE_ALIGNMENT;
+}
+
+MapFileHeader makeHeader(const Map& map) {
+    MapFileHeader header{};
+    std::memcpy(header.magic, MAP_FILE_MAGIC, sizeof(header.magic));
+    header.version = MAP_FILE_VERSION;
+    header.headerSize = sizeof(MapFileHeader);
+    header.width = map.getWidth();
+    header.height = map.getHeight();
+    header.stride = map.getStride();
+    header.stairsX = map.getStairsDown().first;
+    header.stairsY = map.getStairsDown().second;
+    header.spawnX = map.getSpawnPoint().first;
+    header.spawnY = map.getSpawnPoint().second;
+
+    uint64_t typeBytes = static_cast<uint64_t>(map.getStride()) * map.getHeight();
+    uint64_t walkableBytes =
+        static_cast<uint64_t>(map.getWordsPerRow()) * map.getHeight() * sizeof(uint64_t);
+    header.typeOffset = alignUp(sizeof(MapFileHeader));
+    header.walkableOffset = alignUp(header.typeOffset + typeBytes);
+    header.fileSize = header.walkableOffset + walkableBytes;
+    return header;
+}
+
+// Whether [offset, offset + bytes) lies inside a file of `size` bytes,
+// without letting the sum wrap.
+bool fitsIn(uint64_t offset, uint64_t bytes, std::size_t size) {
+    return offset <= size && bytes <= size - offset;
+}
+
+bool isValidHeader(const MapFileHeader& header, std::size_t fileSize) {
+    if (std::memcmp(header.magic, MAP_FILE_MAGIC, sizeof(header.magic)) != 0) return false;
+    if (header.version != MAP_FILE_VERSION) return false;
+    if (header.headerSize != sizeof(MapFileHeader)) return false;
+    if (header.width <= 0 || header.height <= 0) return false;
+    const int64_t stride = (int64_t{header.width} + Map::ROW_ALIGNMENT - 1) / Map::ROW_ALIGNMENT *
+                           Map::ROW_ALIGNMENT;
+    if (header.stride != stride) return false;
+
+    uint64_t typeBytes = static_cast<uint64_t>(header.stride) * header.height;
+    uint64_t walkableBytes = static_cast<uint64_t>(header.stride / 64) * header.height * 8;
+    if (header.typeOffset % MAP_FILE_ALIGNMENT != 0) return false;
+    if (header.walkableOffset % MAP_FILE_ALIGNMENT != 0) return false;
+    if (header.typeOffset < sizeof(MapFileHeader)) return false;
+    if (!fitsIn(header.typeOffset, typeBytes, fileSize)) return false;
+    if (!fitsIn(header.walkableOffset, walkableBytes, fileSize)) return false;
+    if (header.walkableOffset < header.typeOffset + typeBytes) return false;
+    return header.fileSize == header.walkableOffset + walkableBytes;
+}
+
+
+}
+
+MappedFile::MappedFile(std::byte* data, std::size_t size, std::unique_ptr<uint64_t[]> buffer)
+    : m_data(data), m_size(size), m_buffer(std::move(buffer)) {}
+
+MappedFile::~MappedFile() {
+#ifdef RETRO_DUNGEON_HAS_MMAP
+    if (!m_buffer && m_data) {
+        munmap(m_data, m_size);
+    }
+#endif
+}
+
+std::unique_ptr<MappedFile> MappedFile::open(const std::string& filename) {
+#ifdef RETRO_DUNGEON_HAS_MMAP
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+
+    struct stat info {};
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return nullptr;
+    }
+
+    auto size = static_cast<std::size_t>(info.st_size);
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) return nullptr;
+
+    return std::unique_ptr<MappedFile>(
+        new MappedFile(static_cast<std::byte*>(data), size, nullptr));
+#else
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return nullptr;
+
+    auto size = static_cast<std::size_t>(file.tellg());
+    if (size == 0) return nullptr;
+
+    auto buffer = std::make_unique<uint64_t[]>((size + 7) / 8);
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(buffer.get()), static_cast<std::streamsize>(size))) {
+        return nullptr;
+    }
+
+    auto* data = reinterpret_cast<std::byte*>(buffer.get());
+    return std::unique_ptr<MappedFile>(new MappedFile(data, size, std::move(buffer)));
+#endif
+}
+
+bool saveMapFile(const Map& map, const std::string& filename) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    const MapFileHeader header = makeHeader(map);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::vector<char> padding(header.typeOffset - sizeof(header), 0);
+    file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+
+    std::vector<TileType> row(static_cast<std::size_t>(map.getStride()), TileType::Wall);
+    for (int y = 0; y < map.getHeight(); ++y) {
+        auto types = map.typeRow(y);
+        std::copy(types.begin(), types.end(), row.begin());
+        file.write(reinterpret_cast<const char*>(row.data()),
+                   static_cast<std::streamsize>(row.size()));
+    }
+
+    uint64_t typeEnd = header.typeOffset + static_cast<uint64_t>(map.getStride()) * map.getHeight();
+    padding.assign(header.walkableOffset - typeEnd, 0);
+    file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+
+    for (int y = 0; y < map.getHeight(); ++y) {
+        auto words = map.walkableRow(y);
+        file.write(reinterpret_cast<const char*>(words.data()),
+                   static_cast<std::streamsize>(words.size_bytes()));
+    }
+
+    return file.good();
+}
+
+std::unique_ptr<Map> openMapFile(const std::string& filename) {
+    auto mapping = MappedFile::open(filename);
+    if (!mapping || mapping->size() < sizeof(MapFileHeader)) return nullptr;
+
+    MapFileHeader header;
+    std::memcpy(&header, mapping->data(), sizeof(header));
+    if (!isValidHeader(header, mapping->size())) return nullptr;
+
+    auto map = std::unique_ptr<Map>(new Map(header.width, header.height, std::move(mapping),
+                                            header.typeOffset, header.walkableOffset));
+    // The game places the player and the stairs here without checking.
+    if (!map->isWalkable(header.stairsX, header.stairsY) ||
+        !map->isWalkable(header.spawnX, header.spawnY)) {
+        return nullptr;
+    }
+    map->setStairsDown({header.stairsX, header.stairsY});
+    map->setSpawnPoint({header.spawnX, header.spawnY});
+    return map;
+}
+
+bool verifyMapLayers(const Map& map) {
+    const uint64_t padding = map.getWidth() % 64 == 0 ? 0 : ~uint64_t{0} << (map.getWidth() % 64);
+    for (int y = 0; y < map.getHeight(); ++y) {
+        auto types = map.typeRow(y);
+        for (TileType type : types) {
+            if (static_cast<std::size_t>(type) >= TILE_TRAITS.size()) return false;
+        }
+        if (map.walkableRow(y).back() & padding) return false;
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,148 @@
+#include "retro_dungeon/pathfinder.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+
+namespace retro_dungeon {
+
+namespace {
+
+constexpr uint32_t NONE = UINT32_MAX;
+
+struct Step {
+    int dx;
+    int dy;
+    uint32_t cost;
+};
+
+constexpr Step STEPS[] = {
+    {1, 0, Pathfinder::STRAIGHT_COST},   {-1, 0, Pathfinder::STRAIGHT_COST},
+    {0, 1, Pathfinder::STRAIGHT_COST},   {0, -1, Pathfinder::STRAIGHT_COST},
+    {1, 1, Pathfinder::DIAGONAL_COST},   {-1, 1, Pathfinder::DIAGONAL_COST},
+    {1, -1, Pathfinder::DIAGONAL_COST},  {-1, -1, Pathfinder::DIAGONAL_COST},
+};
+
+}
+
+void Pathfinder::prepare(const Map& map) {
+    m_stride = map.getStride();
+    const std::size_t tiles = static_cast<std::size_t>(m_stride) * map.getHeight();
+    if (m_nodes.size() < tiles) {
+        m_nodes.assign(tiles, Node{0, 0, NONE});
+        m_generation = 0;
+    }
+    m_open.reserve(tiles);
+}
+
+bool Pathfinder::findPath(const Map& map, Position start, Position goal,
+                          std::vector<Position>& path, std::size_t maxExpansions) {
+    path.clear();
+    m_expanded = 0;
+    m_pathCost = -1;
+    if (!map.isWalkable(start.first, start.second) || !map.isWalkable(goal.first, goal.second)) {
+        return false;
+    }
+
+    prepare(map);
+    if (++m_generation == 0) {
+        for (Node& node : m_nodes) node.stamp = 0;
+        m_generation = 1;
+    }
+    m_open.clear();
+    m_buckets.fill(NONE);
+    m_bucketMask = 0;
+    m_freeEntry = NONE;
+
+    // The walkable plane is one bit per tile in the same y * stride + x order
+    // as the node pool, so a cell index is also its bit index.
+    const uint64_t* walkable = map.walkableRow(0).data();
+    const auto width = static_cast<unsigned>(map.getWidth());
+    const auto height = static_cast<unsigned>(map.getHeight());
+    const auto isOpen = [&](int x, int y) {
+        if (static_cast<unsigned>(x) >= width || static_cast<unsigned>(y) >= height) return false;
+        const auto cell = static_cast<uint32_t>(y * m_stride + x);
+        return ((walkable[cell >> 6] >> (cell & 63)) & 1) != 0;
+    };
+
+    const auto goalCell = static_cast<uint32_t>(goal.second * m_stride + goal.first);
+    const int steps = m_movement == Movement::Diagonal ? 8 : 4;
+    uint32_t f = heuristic(start.first, start.second, goal.first, goal.second);
+    push(static_cast<uint32_t>(start.second * m_stride + start.first), 0, f, NONE);
+
+    while (m_bucketMask != 0) {
+        f += static_cast<uint32_t>(std::countr_zero(std::rotr(m_bucketMask, static_cast<int>(f % BUCKET_COUNT))));
+        const OpenEntry current = pop(f % BUCKET_COUNT);
+        if (current.g != m_nodes[current.cell].g) continue;
+
+        if (current.cell == goalCell) {
+            m_pathCost = static_cast<int>(current.g);
+            buildPath(goalCell, path);
+            return true;
+        }
+        if (maxExpansions != 0 && m_expanded == maxExpansions) break;
+        ++m_expanded;
+
+        const int y = static_cast<int>(current.cell / static_cast<uint32_t>(m_stride));
+        const int x = static_cast<int>(current.cell) - y * m_stride;
+        for (int s = 0; s < steps; ++s) {
+            const Step& step = STEPS[s];
+            const int nx = x + step.dx;
+            const int ny = y + step.dy;
+            if (!isOpen(nx, ny)) continue;
+            if (step.dx != 0 && step.dy != 0 && (!isOpen(nx, y) || !isOpen(x, ny))) continue;
+
+            const auto cell = static_cast<uint32_t>(ny * m_stride + nx);
+            const uint32_t g = current.g + step.cost;
+            const Node& node = m_nodes[cell];
+            if (node.stamp == m_generation && node.g <= g) continue;
+            push(cell, g, g + heuristic(nx, ny, goal.first, goal.second), current.cell);
+        }
+    }
+    return false;
+}
+
+uint32_t Pathfinder::heuristic(int x, int y, int goalX, int goalY) const {
+    const auto dx = static_cast<uint32_t>(std::abs(x - goalX));
+    const auto dy = static_cast<uint32_t>(std::abs(y - goalY));
+    if (m_movement == Movement::Cardinal) return STRAIGHT_COST * (dx + dy);
+    return STRAIGHT_COST * std::max(dx, dy) + (DIAGONAL_COST - STRAIGHT_COST) * std::min(dx, dy);
+}
+
+// Open entries are linked into the bucket for f % BUCKET_COUNT, newest
+// first, so among equal f the most recently reached (deepest) tile is
+// expanded first. Popped entries go on a free list for the next push.
+void Pathfinder::push(uint32_t cell, uint32_t g, uint32_t f, uint32_t parent) {
+    m_nodes[cell] = {m_generation, g, parent};
+
+    uint32_t entry = m_freeEntry;
+    if (entry != NONE) {
+        m_freeEntry = m_open[entry].next;
+    } else {
+        entry = static_cast<uint32_t>(m_open.size());
+        m_open.emplace_back();
+    }
+    const uint32_t bucket = f % BUCKET_COUNT;
+    m_open[entry] = {cell, g, m_buckets[bucket]};
+    m_buckets[bucket] = entry;
+    m_bucketMask |= uint32_t{1} << bucket;
+}
+
+Pathfinder::OpenEntry Pathfinder::pop(uint32_t bucket) {
+    const uint32_t entry = m_buckets[bucket];
+    const OpenEntry popped = m_open[entry];
+    m_buckets[bucket] = popped.next;
+    if (popped.next == NONE) m_bucketMask &= ~(uint32_t{1} << bucket);
+    m_open[entry].next = m_freeEntry;
+    m_freeEntry = entry;
+    return popped;
+}
+
+void Pathfinder::buildPath(uint32_t goal, std::vector<Position>& path) const {
+    for (uint32_t cell = goal; m_nodes[cell].parent != NONE; cell = m_nodes[cell].parent) {
+        const int y = static_cast<int>(cell / static_cast<uint32_t>(m_stride));
+        path.push_back({static_cast<int>(cell) - y * m_stride, y});
+    }
+    std::reverse(path.begin(), path.end());
+}
+
+}
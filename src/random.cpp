@@ -0,0 +1,168 @@
+#include "retro_dungeon/random.hpp"
+#include <algorithm>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+namespace retro_dungeon {
+
+namespace {
+
+constexpr uint32_t MULTIPLIER_1 = 0x7feb352du;
+constexpr uint32_t MULTIPLIER_2 = 0x846ca68bu;
+
+// Chris Wellons' lowbias32 integer hash.
+constexpr uint32_t lowbias32(uint32_t x) {
+    x ^= x >> 16;
+    x *= MULTIPLIER_1;
+    x ^= x >> 15;
+    x *= MULTIPLIER_2;
+    x ^= x >> 16;
+    return x;
+}
+
+constexpr uint32_t highKey(uint32_t keyHigh, uint32_t counterHigh) {
+    return keyHigh ^ (counterHigh * 0x9e3779b9u);
+}
+
+constexpr uint32_t hashValue(uint32_t low, uint32_t keyLow, uint32_t high) {
+    return lowbias32(lowbias32(low + keyLow) ^ high);
+}
+
+#if defined(__AVX2__)
+__m256i lowbias32(__m256i x) {
+    x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+    x = _mm256_mullo_epi32(x, _mm256_set1_epi32(static_cast<int>(MULTIPLIER_1)));
+    x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 15));
+    x = _mm256_mullo_epi32(x, _mm256_set1_epi32(static_cast<int>(MULTIPLIER_2)));
+    return _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+}
+#elif defined(__SSE4_1__)
+__m128i lowbias32(__m128i x) {
+    x = _mm_xor_si128(x, _mm_srli_epi32(x, 16));
+    x = _mm_mullo_epi32(x, _mm_set1_epi32(static_cast<int>(MULTIPLIER_1)));
+    x = _mm_xor_si128(x, _mm_srli_epi32(x, 15));
+    x = _mm_mullo_epi32(x, _mm_set1_epi32(static_cast<int>(MULTIPLIER_2)));
+    return _mm_xor_si128(x, _mm_srli_epi32(x, 16));
+}
+#endif
+
+// Lemire multiply-shift: (x * range) >> 32, with range == 0 meaning the
+// full 2^32 range.
+constexpr uint32_t bounded(uint32_t x, uint32_t range) {
+    return range == 0 ? x : static_cast<uint32_t>((static_cast<uint64_t>(x) * range) >> 32);
+}
+
+constexpr float unitFloat(uint32_t x) { return static_cast<float>(x >> 8) * 0x1.0p-24f; }
+
+// Values for counters low .. low + count - 1, which all share one high word;
+// the caller never lets a run cross a 2^32 boundary. Integers are written as
+// base + bounded(value, range), floats as the top 24 bits scaled to [0, 1).
+template <typename T>
+void generateRun(T* out, std::size_t count, uint32_t low, uint32_t keyLow, uint32_t high,
+                 uint32_t range, uint32_t base) {
+    constexpr bool TO_FLOAT = std::is_same_v<T, float>;
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i key = _mm256_set1_epi32(static_cast<int>(keyLow));
+    const __m256i mix = _mm256_set1_epi32(static_cast<int>(high));
+    const __m256i scale = _mm256_set1_epi32(static_cast<int>(range));
+    const __m256i offset = _mm256_set1_epi32(static_cast<int>(base));
+    for (; i + 8 <= count; i += 8) {
+        __m256i x = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(low + i)), lanes);
+        x = lowbias32(_mm256_add_epi32(x, key));
+        x = lowbias32(_mm256_xor_si256(x, mix));
+        if constexpr (TO_FLOAT) {
+            __m256 f = _mm256_cvtepi32_ps(_mm256_srli_epi32(x, 8));
+            _mm256_storeu_ps(out + i, _mm256_mul_ps(f, _mm256_set1_ps(0x1.0p-24f)));
+        } else {
+            if (range != 0) {
+                __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(x, scale), 32);
+                __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(x, 32), scale);
+                x = _mm256_blend_epi32(even, odd, 0xaa);
+            }
+            x = _mm256_add_epi32(x, offset);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), x);
+        }
+    }
+#elif defined(__SSE4_1__)
+    const __m128i lanes = _mm_setr_epi32(0, 1, 2, 3);
+    const __m128i key = _mm_set1_epi32(static_cast<int>(keyLow));
+    const __m128i mix = _mm_set1_epi32(static_cast<int>(high));
+    const __m128i scale = _mm_set1_epi32(static_cast<int>(range));
+    const __m128i offset = _mm_set1_epi32(static_cast<int>(base));
+    for (; i + 4 <= count; i += 4) {
+        __m128i x = _mm_add_epi32(_mm_set1_epi32(static_cast<int>(low + i)), lanes);
+        x = lowbias32(_mm_add_epi32(x, key));
+        x = lowbias32(_mm_xor_si128(x, mix));
+        if constexpr (TO_FLOAT) {
+            __m128 f = _mm_cvtepi32_ps(_mm_srli_epi32(x, 8));
+            _mm_storeu_ps(out + i, _mm_mul_ps(f, _mm_set1_ps(0x1.0p-24f)));
+        } else {
+            if (range != 0) {
+                __m128i even = _mm_srli_epi64(_mm_mul_epu32(x, scale), 32);
+                __m128i odd = _mm_mul_epu32(_mm_srli_epi64(x, 32), scale);
+                x = _mm_blend_epi16(even, odd, 0xcc);
+            }
+            x = _mm_add_epi32(x, offset);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), x);
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        const uint32_t x = hashValue(low + static_cast<uint32_t>(i), keyLow, high);
+        if constexpr (TO_FLOAT) {
+            out[i] = unitFloat(x);
+        } else {
+            out[i] = static_cast<T>(base + bounded(x, range));
+        }
+    }
+}
+
+template <typename T>
+void generate(std::span<T> out, uint32_t keyLow, uint32_t keyHigh, uint64_t& counter,
+              uint32_t range = 0, uint32_t base = 0) {
+    std::size_t done = 0;
+    while (done < out.size()) {
+        const auto low = static_cast<uint32_t>(counter);
+        const auto untilWrap = (uint64_t{1} << 32) - low;
+        const auto n = static_cast<std::size_t>(std::min<uint64_t>(out.size() - done, untilWrap));
+
+        generateRun(out.data() + done, n, low, keyLow,
+                    highKey(keyHigh, static_cast<uint32_t>(counter >> 32)), range, base);
+        done += n;
+        counter += n;
+    }
+}
+
+}
+
+BatchRng::BatchRng(uint64_t seed) {
+    const uint64_t key = mix64(seed ^ 0x243f6a8885a308d3ULL);
+    m_keyLow = static_cast<uint32_t>(key);
+    m_keyHigh = static_cast<uint32_t>(key >> 32);
+}
+
+uint32_t BatchRng::valueAt(uint64_t counter) const {
+    return hashValue(static_cast<uint32_t>(counter), m_keyLow,
+                     highKey(m_keyHigh, static_cast<uint32_t>(counter >> 32)));
+}
+
+void BatchRng::fillBits(std::span<uint32_t> out) { generate(out, m_keyLow, m_keyHigh, m_counter); }
+
+void BatchRng::fillBounded(std::span<uint32_t> out, uint32_t range) {
+    generate(out, m_keyLow, m_keyHigh, m_counter, range);
+}
+
+void BatchRng::fillInts(std::span<int> out, int lo, int hi) {
+    const uint32_t base = static_cast<uint32_t>(lo);
+    const uint32_t range = static_cast<uint32_t>(hi) - base + 1;
+    generate(out, m_keyLow, m_keyHigh, m_counter, range, base);
+}
+
+void BatchRng::fillFloats(std::span<float> out) { generate(out, m_keyLow, m_keyHigh, m_counter); }
+
+}
@@ -0,0 +1,34 @@
+#include "retro_dungeon/spawn_sampler.hpp"
+
+namespace retro_dungeon {
+
+void SpawnSampler::reset(const Map& map) {
+    m_width = map.getWidth();
+    m_height = map.getHeight();
+    m_stride = map.getStride();
+    auto cells = map.walkableCells();
+    m_candidates.assign(cells.begin(), cells.end());
+    m_live = m_candidates.size();
+    m_occupied.assign(static_cast<std::size_t>(m_stride / 64) * m_height, 0);
+}
+
+bool SpawnSampler::occupy(Position p) {
+    if (p.first < 0 || p.first >= m_width || p.second < 0 || p.second >= m_height) return false;
+    return claim(static_cast<uint32_t>(p.second * m_stride + p.first));
+}
+
+bool SpawnSampler::isOccupied(Position p) const {
+    if (p.first < 0 || p.first >= m_width || p.second < 0 || p.second >= m_height) return false;
+    const auto cell = static_cast<uint32_t>(p.second * m_stride + p.first);
+    return (m_occupied[cell >> 6] >> (cell & 63)) & 1;
+}
+
+bool SpawnSampler::claim(uint32_t cell) {
+    uint64_t& word = m_occupied[cell >> 6];
+    const uint64_t bit = uint64_t{1} << (cell & 63);
+    if (word & bit) return false;
+    word |= bit;
+    return true;
+}
+
+}
@@ -0,0 +1,83 @@
+#include <catch2/catch_all.hpp>
+#include "retro_dungeon/cellular_automaton.hpp"
+#include "retro_dungeon/random.hpp"
+
+namespace {
+
+// Straightforward per-tile version of the 4-5 rule to check the bitboard one
+// against.
+bool referenceStep(const retro_dungeon::Bitboard& walls, int x, int y) {
+    int count = 0;
+    for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+            if ((dx != 0 || dy != 0) && walls.test(x + dx, y + dy)) ++count;
+        }
+    }
+    return count >= 5 || (walls.test(x, y) && count == 4);
+}
+
+void fillNoise(retro_dungeon::Bitboard& board, uint64_t seed) {
+    retro_dungeon::SplitMix64 rng(seed);
+    for (int y = 0; y < board.getHeight(); ++y) {
+        for (uint64_t& word : board.row(y)) {
+            word = rng();
+        }
+    }
+    board.resetPadding();
+}
+
+}
+
+TEST_CASE("Bitboard basics", "[automaton]") {
+    retro_dungeon::Bitboard board(70, 3, true);
+
+    REQUIRE(board.getWordsPerRow() == 2);
+    REQUIRE(board.count() == 0);
+    REQUIRE(board.test(-1, 0));
+    REQUIRE(board.test(70, 2));
+
+    board.set(69, 1, true);
+    board.set(0, 0, true);
+    board.set(70, 0, false);
+    REQUIRE(board.test(69, 1));
+    REQUIRE(board.count() == 2);
+
+    board.row(2)[1] = ~uint64_t{0};
+    board.resetPadding();
+    REQUIRE(board.count() == 8);
+}
+
+TEST_CASE("Cave automaton matches the per-tile rule", "[automaton]") {
+    // Widths cover a partial word, whole words, and enough words for the
+    // vector loop plus a scalar tail.
+    for (int width : {5, 64, 100, 320, 333}) {
+        retro_dungeon::Bitboard walls(width, 17, true);
+        retro_dungeon::Bitboard next(width, 17, true);
+        fillNoise(walls, static_cast<uint64_t>(width));
+
+        retro_dungeon::stepCaveAutomaton(walls, next);
+
+        for (int y = 0; y < walls.getHeight(); ++y) {
+            for (int x = 0; x < width; ++x) {
+                REQUIRE(next.test(x, y) == referenceStep(walls, x, y));
+            }
+        }
+    }
+}
+
+TEST_CASE("Cave automaton fixed points", "[automaton]") {
+    retro_dungeon::Bitboard walls(40, 10, true);
+    retro_dungeon::Bitboard next(40, 10, true);
+
+    SECTION("An open board stays open away from the edges") {
+        retro_dungeon::stepCaveAutomaton(walls, next);
+        REQUIRE(!next.test(20, 5));
+        REQUIRE(next.test(0, 0));
+    }
+
+    SECTION("A lone wall disappears") {
+        walls.set(20, 5, true);
+        retro_dungeon::stepCaveAutomaton(walls, next);
+        REQUIRE(!next.test(20, 5));
+    }
+}
@@ -0,0 +1,84 @@
+#include <catch2/catch_all.hpp>
+#include "retro_dungeon/chunked_map.hpp"
+
+TEST_CASE("Chunked map starts empty", "[chunked_map]") {
+    retro_dungeon::ChunkedMap map(100000, 100000);
+
+    REQUIRE(map.getChunkCount() == 0);
+    REQUIRE(map.getTileType(99999, 99999) == retro_dungeon::TileType::Wall);
+    REQUIRE(!map.isWalkable(50000, 50000));
+    REQUIRE(!map.isWalkable(100000, 0));
+}
+
+TEST_CASE("Chunked map allocates chunks lazily", "[chunked_map]") {
+    retro_dungeon::ChunkedMap map(100000, 100000);
+
+    SECTION("Writing walls does not allocate") {
+        map.setTile(10, 10, retro_dungeon::TileType::Wall);
+        map.fillRect(0, 0, 1000, 1000, retro_dungeon::TileType::Wall);
+        REQUIRE(map.getChunkCount() == 0);
+    }
+
+    SECTION("Carving allocates only the touched chunks") {
+        map.setTile(70000, 70000, retro_dungeon::TileType::Floor);
+        REQUIRE(map.getChunkCount() == 1);
+        REQUIRE(map.isWalkable(70000, 70000));
+        REQUIRE(map.getTile(70000, 70000).symbol == '.');
+
+        map.fillRect(30, 30, 4, 4, retro_dungeon::TileType::Floor);
+        REQUIRE(map.getChunkCount() == 5);
+        REQUIRE(map.isWalkable(33, 33));
+        REQUIRE(!map.isWalkable(34, 33));
+    }
+
+    SECTION("Chunks walled back up are released") {
+        map.fillRect(0, 0, 64, 64, retro_dungeon::TileType::Floor);
+        REQUIRE(map.getChunkCount() == 4);
+        map.fillRect(0, 0, 32, 64, retro_dungeon::TileType::Wall);
+        REQUIRE(map.getChunkCount() == 2);
+        map.setTile(40, 40, retro_dungeon::TileType::Wall);
+        REQUIRE(map.getChunkCount() == 2);
+    }
+
+    SECTION("Explored tiles keep their chunk alive") {
+        map.setTile(5, 5, retro_dungeon::TileType::Floor);
+        map.setExplored(5, 5, true);
+        map.setTile(5, 5, retro_dungeon::TileType::Wall);
+        REQUIRE(map.getChunkCount() == 1);
+        REQUIRE(map.isExplored(5, 5));
+    }
+}
+
+TEST_CASE("Chunked map ignores empty and off-map rectangles", "[chunked_map]") {
+    retro_dungeon::ChunkedMap map(70, 70);
+    map.fillRect(32, 32, 38, 38, retro_dungeon::TileType::Floor);
+    REQUIRE(map.getChunkCount() == 4);
+
+    map.fillRect(40, 40, -4, 4, retro_dungeon::TileType::Wall);
+    map.fillRect(40, 40, 4, -4, retro_dungeon::TileType::Wall);
+    map.fillRect(75, 0, 5, 5, retro_dungeon::TileType::Floor);
+    map.fillRect(0, 75, 5, 5, retro_dungeon::TileType::Floor);
+    map.fillRect(75, 40, 5, 5, retro_dungeon::TileType::Wall);
+    map.fillRect(40, 75, 5, 5, retro_dungeon::TileType::Wall);
+
+    REQUIRE(map.getChunkCount() == 4);
+    for (int y = 0; y < 70; ++y) {
+        for (int x = 0; x < 70; ++x) {
+            REQUIRE(map.isWalkable(x, y) == (x >= 32 && y >= 32));
+        }
+    }
+}
+
+TEST_CASE("Chunked map blit", "[chunked_map]") {
+    retro_dungeon::Map level(60, 20);
+    level.fillRect(15, 5, 30, 10, retro_dungeon::TileType::Floor);
+    level.setTile(20, 8, retro_dungeon::TileType::StairsDown);
+
+    retro_dungeon::ChunkedMap world(100000, 100000);
+    world.blit(level, 50000, 50000);
+
+    REQUIRE(world.getTileType(50020, 50008) == retro_dungeon::TileType::StairsDown);
+    REQUIRE(world.isWalkable(50015, 50005));
+    REQUIRE(!world.isWalkable(50014, 50005));
+    REQUIRE(world.getChunkCount() <= 4);
+}
@@ -0,0 +1,84 @@
+#include <catch2/catch_all.hpp>
+#include "retro_dungeon/connectivity.hpp"
+#include "retro_dungeon/dungeon_generator.hpp"
+
+TEST_CASE("Component labels", "[connectivity]") {
+    retro_dungeon::Map map(20, 10);
+    map.fillRect(1, 1, 5, 3, retro_dungeon::TileType::Floor);
+    map.fillRect(8, 1, 4, 8, retro_dungeon::TileType::Floor);
+    map.fillRect(12, 8, 6, 1, retro_dungeon::TileType::Floor);
+    map.setTile(15, 5, retro_dungeon::TileType::Door);
+
+    retro_dungeon::ComponentLabels labels;
+    labels.build(map);
+
+    REQUIRE(labels.getComponentCount() == 3);
+    REQUIRE(labels.getLabel(0, 0) == retro_dungeon::ComponentLabels::NONE);
+    REQUIRE(labels.getLabel(-1, 3) == retro_dungeon::ComponentLabels::NONE);
+
+    SECTION("Ids follow raster order") {
+        REQUIRE(labels.getLabel(1, 1) == 0);
+        REQUIRE(labels.getLabel(8, 1) == 1);
+        REQUIRE(labels.getLabel(15, 5) == 2);
+    }
+
+    SECTION("Sizes and bounding boxes") {
+        const auto& room = labels.getComponent(0);
+        REQUIRE(room.size == 15);
+        REQUIRE(room.minX == 1);
+        REQUIRE(room.maxX == 5);
+        REQUIRE(room.minY == 1);
+        REQUIRE(room.maxY == 3);
+
+        const auto& hall = labels.getComponent(1);
+        REQUIRE(hall.size == 32 + 6);
+        REQUIRE(hall.maxX == 17);
+        REQUIRE(hall.maxY == 8);
+
+        REQUIRE(labels.getLargest() == 1);
+    }
+
+    SECTION("Connectivity queries") {
+        REQUIRE(labels.isConnected({8, 1}, {17, 8}));
+        REQUIRE(!labels.isConnected({1, 1}, {8, 1}));
+        REQUIRE(!labels.isConnected({0, 0}, {0, 0}));
+    }
+}
+
+TEST_CASE("Component labels do not depend on thread count", "[connectivity]") {
+    // Raw cave noise has many components, several of which cross the strip
+    // borders and wrap back above themselves.
+    retro_dungeon::Map map(300, 257);
+    retro_dungeon::SplitMix64 rng(8);
+    for (int y = 0; y < map.getHeight(); ++y) {
+        for (int x = 0; x < map.getWidth(); ++x) {
+            if (rng() % 100 < 55) map.setTile(x, y, retro_dungeon::TileType::Floor);
+        }
+    }
+
+    retro_dungeon::ComponentLabels serial;
+    serial.build(map, 1);
+
+    for (int threads : {2, 3, 8}) {
+        retro_dungeon::ComponentLabels parallel;
+        parallel.build(map, threads);
+
+        REQUIRE(parallel.getComponentCount() == serial.getComponentCount());
+        for (std::size_t id = 0; id < serial.getComponentCount(); ++id) {
+            const auto& a = serial.getComponent(static_cast<int>(id));
+            const auto& b = parallel.getComponent(static_cast<int>(id));
+            REQUIRE(a.size == b.size);
+            REQUIRE(a.minX == b.minX);
+            REQUIRE(a.maxX == b.maxX);
+            REQUIRE(a.minY == b.minY);
+            REQUIRE(a.maxY == b.maxY);
+        }
+        bool same = true;
+        for (int y = 0; y < map.getHeight(); ++y) {
+            for (int x = 0; x < map.getWidth(); ++x) {
+                same = same && parallel.getLabel(x, y) == serial.getLabel(x, y);
+            }
+        }
+        REQUIRE(same);
+    }
+}
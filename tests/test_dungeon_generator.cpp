@@ -0,0 +1,104 @@
+#include <catch2/catch_all.hpp>
+#include "retro_dungeon/dungeon_generator.hpp"
+#include <vector>
+
+namespace {
+
+std::size_t countReachable(const retro_dungeon::Map& map, retro_dungeon::Position start) {
+    const int width = map.getWidth();
+    std::vector<bool> seen(static_cast<std::size_t>(width) * map.getHeight(), false);
+    std::vector<retro_dungeon::Position> stack{start};
+    seen[static_cast<std::size_t>(start.second) * width + start.first] = true;
+
+    std::size_t reached = 0;
+    while (!stack.empty()) {
+        auto [x, y] = stack.back();
+        stack.pop_back();
+        ++reached;
+
+        const retro_dungeon::Position neighbours[] = {{x + 1, y}, {x - 1, y}, {x, y + 1}, {x, y - 1}};
+        for (auto [nx, ny] : neighbours) {
+            if (!map.isValidPosition(nx, ny) || !map.isWalkable(nx, ny)) continue;
+            auto i = static_cast<std::size_t>(ny) * width + nx;
+            if (seen[i]) continue;
+            seen[i] = true;
+            stack.push_back({nx, ny});
+        }
+    }
+    return reached;
+}
+
+}
+
+TEST_CASE("BSP levels are connected", "[generator]") {
+    for (uint64_t seed = 1; seed <= 20; ++seed) {
+        retro_dungeon::DungeonGenerator gen(seed);
+        auto map = gen.generate(60, 20);
+
+        auto spawn = map->getSpawnPoint();
+        auto stairs = map->getStairsDown();
+        REQUIRE(map->isWalkable(spawn.first, spawn.second));
+        REQUIRE(map->getTileType(stairs.first, stairs.second) == retro_dungeon::TileType::StairsDown);
+        REQUIRE(spawn != stairs);
+        REQUIRE(countReachable(*map, spawn) == map->countWalkable());
+    }
+}
+
+TEST_CASE("BSP levels keep a solid border", "[generator]") {
+    retro_dungeon::DungeonGenerator gen(5);
+    auto map = gen.generate(97, 41);
+
+    for (int x = 0; x < map->getWidth(); ++x) {
+        REQUIRE(!map->isWalkable(x, 0));
+        REQUIRE(!map->isWalkable(x, map->getHeight() - 1));
+    }
+    for (int y = 0; y < map->getHeight(); ++y) {
+        REQUIRE(!map->isWalkable(0, y));
+        REQUIRE(!map->isWalkable(map->getWidth() - 1, y));
+    }
+}
+
+TEST_CASE("BSP generator sizes", "[generator]") {
+    retro_dungeon::DungeonGenerator gen(11);
+
+    SECTION("Maps too small for a room stay solid") {
+        auto map = gen.generate(4, 4);
+        REQUIRE(map->countWalkable() == 0);
+        REQUIRE(map->getStairsDown() == retro_dungeon::INVALID_POSITION);
+    }
+
+    SECTION("A single-leaf map still gets a room") {
+        auto map = gen.generate(8, 8);
+        REQUIRE(map->countWalkable() >= 9);
+        REQUIRE(map->getSpawnPoint() != map->getStairsDown());
+    }
+
+    SECTION("Large maps are fully connected") {
+        auto map = gen.generate(1024, 512);
+        REQUIRE(map->countWalkable() > 1024 * 512 / 4);
+        REQUIRE(countReachable(*map, map->getSpawnPoint()) == map->countWalkable());
+    }
+}
+
+TEST_CASE("Cave levels", "[generator]") {
+    retro_dungeon::DungeonGenerator gen1(21);
+    retro_dungeon::DungeonGenerator gen2(21);
+    auto map = gen1.generate(200, 80, retro_dungeon::DungeonStyle::Caves);
+    auto again = gen2.generate(200, 80, retro_dungeon::DungeonStyle::Caves);
+
+    auto spawn = map->getSpawnPoint();
+    auto stairs = map->getStairsDown();
+    REQUIRE(map->isWalkable(spawn.first, spawn.second));
+    REQUIRE(map->getTileType(stairs.first, stairs.second) == retro_dungeon::TileType::StairsDown);
+    REQUIRE(spawn != stairs);
+
+    std::size_t open = map->countWalkable();
+    REQUIRE(open > 200 * 80 / 3);
+    REQUIRE(open < 200 * 80);
+    REQUIRE(again->countWalkable() == open);
+    REQUIRE(countReachable(*map, spawn) == open);
+    for (int x = 0; x < map->getWidth(); ++x) {
+        REQUIRE(!map->isWalkable(x, 0));
+        REQUIRE(!map->isWalkable(x, map->getHeight() - 1));
+    }
+}
@@ -1,5 +1,6 @@
 #include <catch2/catch_all.hpp>
 #include "retro_dungeon/game.hpp"
+#include <vector>
 
 TEST_CASE("Enemy initialization", "[enemy]") {
     retro_dungeon::Enemy enemy(1, retro_dungeon::EnemyType::Goblin, {5, 5});
@@ -41,4 +42,120 @@ TEST_CASE("Enemy combat", "[enemy]") {
         enemy.takeDamage(50);
         REQUIRE(!enemy.isAlive());
     }
-}
\ No newline at end of file
+}
+TEST_CASE("Enemy store handles", "[enemy]") {
+    retro_dungeon::EnemyStore store;
+    const auto goblin = store.create(retro_dungeon::EnemyType::Goblin, {1, 2});
+    const auto orc = store.create(retro_dungeon::EnemyType::Orc, {3, 4});
+    const auto rat = store.create(retro_dungeon::EnemyType::Rat, {5, 6});
+
+    REQUIRE(store.size() == 3);
+    REQUIRE(goblin != retro_dungeon::INVALID_ENTITY_ID);
+    REQUIRE(!store.contains(retro_dungeon::INVALID_ENTITY_ID));
+
+    SECTION("Columns start from the type's stats") {
+        const std::size_t i = store.indexOf(orc);
+        REQUIRE(store.types()[i] == retro_dungeon::EnemyType::Orc);
+        REQUIRE(store.positions()[i] == retro_dungeon::Position{3, 4});
+        REQUIRE(store.health()[i] == 40);
+        REQUIRE(store.maxHealth()[i] == 40);
+        REQUIRE(store.attack()[i] == 10);
+        REQUIRE(store.defense()[i] == 5);
+    }
+
+    SECTION("Destroy keeps the other handles valid") {
+        store.destroy(goblin);
+        REQUIRE(store.size() == 2);
+        REQUIRE(!store.contains(goblin));
+        REQUIRE(store.positions()[store.indexOf(rat)] == retro_dungeon::Position{5, 6});
+        REQUIRE(store.positions()[store.indexOf(orc)] == retro_dungeon::Position{3, 4});
+        store.destroy(goblin);
+        REQUIRE(store.size() == 2);
+    }
+
+    SECTION("Reused slots get a new generation") {
+        store.destroy(orc);
+        const auto spider = store.create(retro_dungeon::EnemyType::Spider, {7, 8});
+        REQUIRE(spider != orc);
+        REQUIRE(!store.contains(orc));
+        REQUIRE(store.types()[store.indexOf(spider)] == retro_dungeon::EnemyType::Spider);
+    }
+
+    SECTION("Clear invalidates every handle") {
+        store.clear();
+        REQUIRE(store.empty());
+        REQUIRE(!store.contains(goblin));
+        REQUIRE(!store.contains(rat));
+    }
+}
+
+TEST_CASE("Enemy store removes the dead in one pass", "[enemy]") {
+    retro_dungeon::EnemyStore store;
+    std::vector<retro_dungeon::EntityId> ids;
+    for (int i = 0; i < 10; ++i) {
+        ids.push_back(store.create(retro_dungeon::EnemyType::Goblin, {i, 0}));
+    }
+    for (int i : {0, 3, 4, 9}) {
+        const std::size_t index = store.indexOf(ids[i]);
+        store.health()[index] = 0;
+        store.lastAttacker()[index] = 77;
+    }
+    store.health()[store.indexOf(ids[5])] = -3;
+
+    std::vector<retro_dungeon::EnemyDeath> deaths;
+    REQUIRE(store.removeDead(deaths) == 5);
+    REQUIRE(store.size() == 5);
+
+    REQUIRE(deaths.size() == 5);
+    REQUIRE(deaths[0].id == ids[0]);
+    REQUIRE(deaths[0].killer == 77);
+    REQUIRE(deaths[3].id == ids[5]);
+    REQUIRE(deaths[3].killer == retro_dungeon::INVALID_ENTITY_ID);
+    REQUIRE(deaths[4].pos == retro_dungeon::Position{9, 0});
+
+    std::vector<int> survivors;
+    for (auto pos : store.positions()) {
+        survivors.push_back(pos.first);
+    }
+    REQUIRE(survivors == std::vector<int>{1, 2, 6, 7, 8});
+    for (int i : {1, 2, 6, 7, 8}) {
+        REQUIRE(store.positions()[store.indexOf(ids[i])].first == i);
+    }
+    REQUIRE(!store.contains(ids[4]));
+
+    deaths.clear();
+    REQUIRE(store.removeDead(deaths) == 0);
+    REQUIRE(deaths.empty());
+}
+
+TEST_CASE("Enemy archetypes", "[enemy]") {
+    using retro_dungeon::EnemyType;
+
+    SECTION("Level 1 is the base archetype") {
+        STATIC_REQUIRE(retro_dungeon::enemyStats(EnemyType::Goblin).health == 20);
+        STATIC_REQUIRE(retro_dungeon::archetype(EnemyType::Spider).symbol == 'x');
+        STATIC_REQUIRE(retro_dungeon::archetype(EnemyType::Zombie).name == "Zombie");
+    }
+
+    SECTION("Stats scale with depth") {
+        constexpr auto orc = retro_dungeon::enemyStats(EnemyType::Orc, 5);
+        STATIC_REQUIRE(orc.health == 64);
+        STATIC_REQUIRE(orc.maxHealth == 64);
+        STATIC_REQUIRE(orc.attackPower == 12);
+        STATIC_REQUIRE(orc.defense == 6);
+
+        const auto& deepest = retro_dungeon::enemyStats(EnemyType::Orc, retro_dungeon::MAX_SCALED_LEVEL);
+        REQUIRE(&retro_dungeon::enemyStats(EnemyType::Orc, 1000) == &deepest);
+        REQUIRE(&retro_dungeon::enemyStats(EnemyType::Orc, 0) == &retro_dungeon::enemyStats(EnemyType::Orc));
+    }
+
+    SECTION("Instances share the interned name") {
+        retro_dungeon::Enemy rat(1, EnemyType::Rat, {0, 0}, 3);
+        REQUIRE(rat.name.data() == retro_dungeon::archetype(EnemyType::Rat).name.data());
+        REQUIRE(rat.attackPower == 3);
+
+        retro_dungeon::EnemyStore store;
+        const auto id = store.create(EnemyType::Rat, {0, 0}, 3);
+        REQUIRE(store.attack()[store.indexOf(id)] == 3);
+    }
+}
@@ -0,0 +1,136 @@
+#include <catch2/catch_all.hpp>
+#include "retro_dungeon/field_of_view.hpp"
+#include "retro_dungeon/random.hpp"
+#include <vector>
+
+namespace {
+
+// Tiles open with probability `open` percent, inside a wall border.
+void fillNoise(retro_dungeon::Map& map, int open, uint64_t seed) {
+    retro_dungeon::SplitMix64 rng(seed);
+    for (int y = 1; y < map.getHeight() - 1; ++y) {
+        for (int x = 1; x < map.getWidth() - 1; ++x) {
+            if (static_cast<int>(rng() % 100) < open) map.setTile(x, y, retro_dungeon::TileType::Floor);
+        }
+    }
+}
+
+}
+
+TEST_CASE("Field of view", "[field_of_view]") {
+    retro_dungeon::Map map(60, 40);
+    map.fillRect(1, 1, 58, 38, retro_dungeon::TileType::Floor);
+    retro_dungeon::FieldOfView fov;
+
+    SECTION("An open room shows a disc of the radius") {
+        fov.compute(map, {30, 20}, 5);
+        int disc = 0;
+        for (int dy = -5; dy <= 5; ++dy) {
+            for (int dx = -5; dx <= 5; ++dx) disc += dx * dx + dy * dy <= 25;
+        }
+        REQUIRE(map.countVisible() == static_cast<std::size_t>(disc));
+        REQUIRE(map.countExplored() == static_cast<std::size_t>(disc));
+        REQUIRE(map.isVisible(35, 20));
+        REQUIRE(!map.isVisible(34, 24));
+        REQUIRE(fov.getBoundsWidth() == 11);
+        REQUIRE(fov.getBoundsHeight() == 11);
+    }
+
+    SECTION("Walls block sight and are shown themselves") {
+        map.setTile(32, 20, retro_dungeon::TileType::Wall);
+        fov.compute(map, {30, 20}, 10);
+        REQUIRE(map.isVisible(32, 20));
+        REQUIRE(!map.isVisible(33, 20));
+        REQUIRE(!map.isVisible(38, 20));
+        REQUIRE(map.isVisible(38, 22));
+
+        fov.compute(map, {3, 3}, 20);
+        REQUIRE(map.isVisible(0, 3));
+        REQUIRE(map.isVisible(3, 0));
+        REQUIRE(fov.getBoundsX() == 0);
+        REQUIRE(fov.getBoundsY() == 0);
+    }
+
+    SECTION("Only the last view is visible; every view stays explored") {
+        fov.compute(map, {10, 10}, 6);
+        const std::size_t first = map.countVisible();
+        fov.compute(map, {45, 25}, 6);
+        REQUIRE(map.countVisible() == first);
+        REQUIRE(!map.isVisible(10, 10));
+        REQUIRE(map.isExplored(10, 10));
+        REQUIRE(map.countExplored() == 2 * first);
+
+        retro_dungeon::Map other(60, 40);
+        other.fillRect(1, 1, 58, 38, retro_dungeon::TileType::Floor);
+        other.setVisible(50, 5, true);
+        fov.compute(other, {10, 10}, 6);
+        REQUIRE(other.countVisible() == first);
+    }
+
+    SECTION("Sight is symmetric") {
+        for (int open : {55, 70, 85}) {
+            retro_dungeon::Map noise(50, 40);
+            fillNoise(noise, open, static_cast<uint64_t>(open));
+            noise.trackWalkableCells();
+            const auto cells = noise.walkableCells();
+            retro_dungeon::SplitMix64 rng(3);
+            int seen = 0;
+            for (int i = 0; i < 300; ++i) {
+                const auto a = noise.cellPosition(cells[retro_dungeon::uniformInt(rng, 0, static_cast<int>(cells.size()) - 1)]);
+                const auto b = noise.cellPosition(cells[retro_dungeon::uniformInt(rng, 0, static_cast<int>(cells.size()) - 1)]);
+                fov.compute(noise, a, 12);
+                const bool aSeesB = noise.isVisible(b.first, b.second);
+                fov.compute(noise, b, 12);
+                REQUIRE(noise.isVisible(a.first, a.second) == aSeesB);
+                seen += aSeesB;
+            }
+            REQUIRE(seen > 0);
+        }
+    }
+
+    SECTION("Origins on the map edge") {
+        fov.compute(map, {0, 0}, 8);
+        REQUIRE(map.isVisible(0, 0));
+        fov.compute(map, {58, 38}, 8);
+        REQUIRE(map.isVisible(59, 39));
+        REQUIRE(map.isVisible(51, 38));
+    }
+}
+
+TEST_CASE("Observer views are reused until they can change", "[field_of_view]") {
+    retro_dungeon::Map map(80, 40);
+    map.fillRect(1, 1, 78, 38, retro_dungeon::TileType::Floor);
+    map.fillRect(20, 5, 1, 10, retro_dungeon::TileType::Wall);
+    retro_dungeon::ObserverView view;
+
+    REQUIRE(view.update(map, {15, 10}, 8));
+    REQUIRE(!view.update(map, {15, 10}, 8));
+    REQUIRE(view.sees({19, 10}));
+    REQUIRE(view.sees({20, 10}));
+    REQUIRE(!view.sees({22, 10}));
+    REQUIRE(!view.sees({40, 10}));
+
+    SECTION("Matches the plane written by compute") {
+        retro_dungeon::FieldOfView fov;
+        fov.compute(map, {15, 10}, 8);
+        for (int y = 0; y < map.getHeight(); ++y) {
+            for (int x = 0; x < map.getWidth(); ++x) REQUIRE(view.sees({x, y}) == map.isVisible(x, y));
+        }
+    }
+
+    SECTION("Changes out of view keep it") {
+        map.setTile(60, 30, retro_dungeon::TileType::Wall);
+        REQUIRE(!view.update(map, {15, 10}, 8));
+        REQUIRE(view.getRecomputeCount() == 1);
+    }
+
+    SECTION("Changes in view, moves and bulk writes recompute it") {
+        map.setTile(20, 10, retro_dungeon::TileType::Floor);
+        REQUIRE(view.update(map, {15, 10}, 8));
+        REQUIRE(view.sees({22, 10}));
+        REQUIRE(view.update(map, {16, 10}, 8));
+        map.clear();
+        REQUIRE(view.update(map, {16, 10}, 8));
+        REQUIRE(view.getRecomputeCount() == 4);
+    }
+}
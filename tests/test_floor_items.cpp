@@ -0,0 +1,61 @@
+#include <catch2/catch_all.hpp>
+#include "retro_dungeon/floor_items.hpp"
+#include <vector>
+
+TEST_CASE("Floor item stacks", "[floor_items]") {
+    retro_dungeon::ItemStore items;
+    const auto potion = items.define({"Potion", retro_dungeon::ItemType::Potion, '!', 20, 0, 25});
+    const auto a = items.create(potion);
+    const auto b = items.create(potion);
+    const auto c = items.create(potion);
+
+    retro_dungeon::FloorItems floor;
+    floor.reset(80, 30);
+    REQUIRE(floor.drop({4, 4}, a));
+    REQUIRE(floor.drop({4, 4}, b));
+    REQUIRE(floor.drop({70, 20}, c));
+    REQUIRE(!floor.drop({80, 0}, c));
+    REQUIRE(floor.size() == 3);
+
+    SECTION("Stacks are last in, first out") {
+        REQUIRE(floor.countAt({4, 4}) == 2);
+        REQUIRE(floor.top({4, 4}) == b);
+        REQUIRE(floor.pickUp({4, 4}) == b);
+        REQUIRE(floor.pickUp({4, 4}) == a);
+        REQUIRE(floor.pickUp({4, 4}) == retro_dungeon::INVALID_ITEM_HANDLE);
+        REQUIRE(floor.top({5, 5}) == retro_dungeon::INVALID_ITEM_HANDLE);
+        REQUIRE(floor.size() == 1);
+    }
+
+    SECTION("Remove from the middle of a stack") {
+        REQUIRE(floor.drop({4, 4}, c));
+        REQUIRE(floor.remove({4, 4}, b));
+        REQUIRE(!floor.remove({4, 4}, b));
+        std::vector<retro_dungeon::ItemHandle> stack;
+        floor.forEachAt({4, 4}, [&](retro_dungeon::ItemHandle item) { stack.push_back(item); });
+        REQUIRE(stack == std::vector<retro_dungeon::ItemHandle>{c, a});
+    }
+
+    SECTION("Radius queries") {
+        std::vector<retro_dungeon::ItemHandle> nearby;
+        floor.forEachInRadius({5, 5}, 2, [&](retro_dungeon::Position p, retro_dungeon::ItemHandle item) {
+            REQUIRE(p == retro_dungeon::Position{4, 4});
+            nearby.push_back(item);
+        });
+        REQUIRE(nearby.size() == 2);
+
+        std::size_t all = 0;
+        floor.forEach([&](retro_dungeon::Position, retro_dungeon::ItemHandle) { ++all; });
+        REQUIRE(all == 3);
+
+        std::size_t piles = 0;
+        floor.forEachPile([&](retro_dungeon::Position, retro_dungeon::ItemHandle) { ++piles; });
+        REQUIRE(piles == 2);
+    }
+
+    SECTION("Reset empties every tile") {
+        floor.reset(80, 30);
+        REQUIRE(floor.size() == 0);
+        REQUIRE(floor.top({4, 4}) == retro_dungeon::INVALID_ITEM_HANDLE);
+    }
+}
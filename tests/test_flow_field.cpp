@@ -0,0 +1,157 @@
+#include <catch2/catch_all.hpp>
+#include "retro_dungeon/dungeon_generator.hpp"
+#include "retro_dungeon/flow_field.hpp"
+#include "retro_dungeon/pathfinder.hpp"
+#include <vector>
+
+namespace {
+
+void requireSameField(const retro_dungeon::Map& map, const retro_dungeon::FlowField& a,
+                      const retro_dungeon::FlowField& b) {
+    for (int y = 0; y < map.getHeight(); ++y) {
+        for (int x = 0; x < map.getWidth(); ++x) {
+            REQUIRE(a.valueAt({x, y}) == b.valueAt({x, y}));
+        }
+    }
+}
+
+}
+
+TEST_CASE("Flow field distances", "[flow_field]") {
+    retro_dungeon::Map map(40, 12);
+    map.fillRect(1, 1, 38, 10, retro_dungeon::TileType::Floor);
+    map.fillRect(20, 1, 1, 8, retro_dungeon::TileType::Wall);
+    map.fillRect(30, 1, 1, 10, retro_dungeon::TileType::Wall);
+    retro_dungeon::FlowField field;
+
+    SECTION("Single source matches A* distances") {
+        const retro_dungeon::Position source{10, 5};
+        field.compute(map, {&source, 1});
+        retro_dungeon::Pathfinder pathfinder;
+        std::vector<retro_dungeon::Position> path;
+        for (int y = 0; y < map.getHeight(); ++y) {
+            for (int x = 0; x < map.getWidth(); ++x) {
+                const int value = field.valueAt({x, y});
+                if (pathfinder.findPath(map, source, {x, y}, path)) {
+                    REQUIRE(value == static_cast<int>(path.size()));
+                } else {
+                    REQUIRE(value == retro_dungeon::FlowField::UNREACHABLE);
+                }
+            }
+        }
+        REQUIRE(field.valueAt({-1, 0}) == retro_dungeon::FlowField::UNREACHABLE);
+        REQUIRE(field.valueAt({35, 5}) == retro_dungeon::FlowField::UNREACHABLE);
+    }
+
+    SECTION("Nearest of several sources") {
+        const retro_dungeon::Position sources[] = {{2, 2}, {25, 2}};
+        field.compute(map, sources);
+        REQUIRE(field.valueAt({2, 2}) == 0);
+        REQUIRE(field.valueAt({25, 2}) == 0);
+        REQUIRE(field.valueAt({5, 2}) == 3);
+        REQUIRE(field.valueAt({22, 2}) == 3);
+        REQUIRE(field.valueAt({19, 1}) == 18);
+    }
+
+    SECTION("Downhill steps reach the source") {
+        const retro_dungeon::Position source{25, 2};
+        field.compute(map, {&source, 1});
+        retro_dungeon::Position p{2, 2};
+        int steps = 0;
+        for (auto next = field.downhill(p); next != p; next = field.downhill(p)) {
+            REQUIRE(field.valueAt(next) == field.valueAt(p) - 1);
+            p = next;
+            ++steps;
+        }
+        REQUIRE(p == source);
+        REQUIRE(steps == 37);
+    }
+}
+
+TEST_CASE("Flow field follows a moving source", "[flow_field]") {
+    retro_dungeon::DungeonGenerator generator(4);
+    auto map = generator.generate(80, 40, retro_dungeon::DungeonStyle::Caves);
+    retro_dungeon::FlowField field;
+    retro_dungeon::FlowField fresh;
+
+    retro_dungeon::Position source = map->getSpawnPoint();
+    field.follow(*map, source);
+    REQUIRE(field.getRebuildCount() == 1);
+
+    retro_dungeon::SplitMix64 rng(21);
+    constexpr int DX[] = {0, 0, 1, -1};
+    constexpr int DY[] = {-1, 1, 0, 0};
+    int moves = 0;
+    for (int i = 0; i < 200; ++i) {
+        const int d = retro_dungeon::uniformInt(rng, 0, 3);
+        const retro_dungeon::Position next{source.first + DX[d], source.second + DY[d]};
+        if (!map->isWalkable(next.first, next.second)) continue;
+        source = next;
+        field.follow(*map, source);
+        fresh.compute(*map, {&source, 1});
+        requireSameField(*map, field, fresh);
+        ++moves;
+    }
+    REQUIRE(moves > 0);
+    REQUIRE(field.getRebuildCount() == 1);
+    REQUIRE(field.getFollowCount() == static_cast<std::size_t>(moves));
+
+    SECTION("A jump or a map change recomputes") {
+        map->setTile(source.first + 1, source.second, retro_dungeon::TileType::Wall);
+        field.follow(*map, source);
+        REQUIRE(field.getRebuildCount() == 2);
+        fresh.compute(*map, {&source, 1});
+        requireSameField(*map, field, fresh);
+
+        map->trackWalkableCells();
+        const retro_dungeon::Position far = map->cellPosition(map->walkableCells().front());
+        REQUIRE(field.valueAt(far) > 1);
+        field.follow(*map, far);
+        REQUIRE(field.getRebuildCount() == 3);
+    }
+}
+
+TEST_CASE("Flow field recomputes when leaving a wall", "[flow_field]") {
+    retro_dungeon::Map map(12, 8);
+    map.fillRect(1, 1, 10, 6, retro_dungeon::TileType::Floor);
+    map.fillRect(5, 1, 1, 5, retro_dungeon::TileType::Wall);
+    retro_dungeon::FlowField field;
+    retro_dungeon::FlowField fresh;
+
+    const retro_dungeon::Position wall{5, 3};
+    const retro_dungeon::Position floor{4, 3};
+    field.follow(map, wall);
+    REQUIRE(field.valueAt(floor) == 1);
+
+    field.follow(map, floor);
+    REQUIRE(field.getRebuildCount() == 2);
+    fresh.compute(map, {&floor, 1});
+    requireSameField(map, field, fresh);
+}
+
+TEST_CASE("Flee fields", "[flow_field]") {
+    // A corridor with the threat two tiles from its west end.
+    retro_dungeon::Map map(40, 5);
+    map.fillRect(1, 2, 38, 1, retro_dungeon::TileType::Floor);
+    retro_dungeon::FlowField chase;
+    retro_dungeon::FlowField flee;
+    const retro_dungeon::Position threat{3, 2};
+    chase.compute(map, {&threat, 1});
+    flee.computeFlee(map, chase);
+
+    REQUIRE(flee.valueAt({38, 2}) == -42);
+    REQUIRE(flee.valueAt({3, 2}) < 0);
+    REQUIRE(flee.downhill({6, 2}) == retro_dungeon::Position{7, 2});
+    REQUIRE(flee.valueAt({0, 0}) == retro_dungeon::FlowField::UNREACHABLE);
+
+    // Neighbouring values never differ by more than one step.
+    for (int x = 1; x < 38; ++x) {
+        REQUIRE(flee.valueAt({x + 1, 2}) <= flee.valueAt({x, 2}) + 1);
+        REQUIRE(flee.valueAt({x, 2}) <= flee.valueAt({x + 1, 2}) + 1);
+    }
+
+    // In the short dead end behind the threat, fleeing means running past
+    // it towards the long corridor.
+    REQUIRE(flee.downhill({1, 2}) == retro_dungeon::Position{2, 2});
+    REQUIRE(flee.downhill({2, 2}) == retro_dungeon::Position{3, 2});
+}
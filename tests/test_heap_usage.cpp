@@ -0,0 +1,73 @@
+#include <catch2/catch_all.hpp>
+#include "retro_dungeon/game.hpp"
+#include <cstdlib>
+#include <new>
+
+// Replaces the global allocation functions to count heap use, so this file
+// builds into its own executable rather than the main test binary.
+
+namespace {
+
+// Counts general-heap allocations made by this thread while enabled.
+thread_local bool g_countAllocations = false;
+thread_local std::size_t g_allocations = 0;
+
+void* allocate(std::size_t size) {
+    if (g_countAllocations) ++g_allocations;
+    if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+
+void* allocate(std::size_t size, std::align_val_t alignment) {
+    if (g_countAllocations) ++g_allocations;
+    const auto align = static_cast<std::size_t>(alignment);
+    if (void* p = std::aligned_alloc(align, (size + align - 1) / align * align)) return p;
+    throw std::bad_alloc();
+}
+
+}
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocate(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocate(size, alignment); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+TEST_CASE("Steady-state play does not touch the heap", "[arena]") {
+    retro_dungeon::Game game;
+    game.initialize();
+    game.newGame("Hero");
+
+    // Pace between the spawn and a neighbouring tile that is not the stairs,
+    // so the level never changes.
+    auto* map = game.getMap();
+    const auto [x, y] = game.getPlayer()->pos;
+    const bool northIsStairs = map->getTileType(x, y - 1) == retro_dungeon::TileType::StairsDown;
+    const auto away = northIsStairs ? retro_dungeon::Direction::South : retro_dungeon::Direction::North;
+    const auto back = northIsStairs ? retro_dungeon::Direction::North : retro_dungeon::Direction::South;
+
+    auto playTurns = [&](int turns) {
+        for (int turn = 0; turn < turns; ++turn) {
+            game.handleMovement(turn % 2 == 0 ? away : back);
+            game.update();
+            game.addMessage("The torch flickers.");
+        }
+    };
+    playTurns(50);
+
+    g_allocations = 0;
+    g_countAllocations = true;
+    playTurns(1000);
+    g_countAllocations = false;
+
+    REQUIRE(g_allocations == 0);
+    REQUIRE(game.getPlayer()->dungeonLevel == 1);
+}
@@ -0,0 +1,183 @@
+#include <catch2/catch_all.hpp>
+#include "retro_dungeon/dungeon_generator.hpp"
+#include "retro_dungeon/hierarchical_pathfinder.hpp"
+#include "retro_dungeon/pathfinder.hpp"
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+// Tiles open with probability `open` percent, inside a wall border.
+void fillNoise(retro_dungeon::Map& map, int open, uint64_t seed) {
+    retro_dungeon::SplitMix64 rng(seed);
+    for (int y = 1; y < map.getHeight() - 1; ++y) {
+        for (int x = 1; x < map.getWidth() - 1; ++x) {
+            if (static_cast<int>(rng() % 100) < open) map.setTile(x, y, retro_dungeon::TileType::Floor);
+        }
+    }
+}
+
+// Every query agrees with A* on reachability, refines into a walkable
+// 4-connected path of getPathLength() steps, and is never shorter than
+// A*'s optimum. Returns the summed lengths as {hierarchical, optimal}.
+std::pair<long, long> requireValidPaths(const retro_dungeon::Map& map, retro_dungeon::HierarchicalPathfinder& hpa,
+                                        uint64_t seed, int queries) {
+    retro_dungeon::Pathfinder astar;
+    std::vector<retro_dungeon::Position> expected;
+    std::vector<retro_dungeon::Position> waypoints;
+    std::vector<retro_dungeon::Position> steps;
+    retro_dungeon::SplitMix64 rng(seed);
+
+    std::pair<long, long> lengths{0, 0};
+    for (int i = 0; i < queries; ++i) {
+        const retro_dungeon::Position start{retro_dungeon::uniformInt(rng, 0, map.getWidth() - 1),
+                                            retro_dungeon::uniformInt(rng, 0, map.getHeight() - 1)};
+        const retro_dungeon::Position goal{retro_dungeon::uniformInt(rng, 0, map.getWidth() - 1),
+                                           retro_dungeon::uniformInt(rng, 0, map.getHeight() - 1)};
+        const bool reachable = astar.findPath(map, start, goal, expected);
+        REQUIRE(hpa.findPath(map, start, goal, waypoints) == reachable);
+        if (!reachable) {
+            REQUIRE(waypoints.empty());
+            REQUIRE(hpa.getPathLength() == -1);
+            continue;
+        }
+
+        int length = 0;
+        retro_dungeon::Position prev = start;
+        for (const auto& waypoint : waypoints) {
+            REQUIRE(hpa.refine(map, prev, waypoint, steps));
+            for (const auto& p : steps) {
+                REQUIRE(map.isWalkable(p.first, p.second));
+                REQUIRE(std::abs(p.first - prev.first) + std::abs(p.second - prev.second) == 1);
+                prev = p;
+            }
+            REQUIRE(prev == waypoint);
+            length += static_cast<int>(steps.size());
+        }
+        REQUIRE(prev == goal);
+        REQUIRE(length == hpa.getPathLength());
+        REQUIRE(length * retro_dungeon::Pathfinder::STRAIGHT_COST >= astar.getPathCost());
+        lengths.first += length;
+        lengths.second += astar.getPathCost() / retro_dungeon::Pathfinder::STRAIGHT_COST;
+    }
+    REQUIRE(lengths.second > 0);
+    return lengths;
+}
+
+}
+
+TEST_CASE("Hierarchical pathfinder finds near-optimal paths", "[hierarchical_pathfinder]") {
+    SECTION("Noise maps") {
+        for (int open : {60, 75, 90}) {
+            retro_dungeon::Map map(90, 50);
+            fillNoise(map, open, static_cast<uint64_t>(open));
+            retro_dungeon::HierarchicalPathfinder hpa(10);
+            requireValidPaths(map, hpa, 5, 300);
+            REQUIRE(hpa.getClusterCount() == 9 * 5);
+        }
+    }
+
+    SECTION("Generated levels stay within a few percent of optimal") {
+        retro_dungeon::DungeonGenerator generator(8);
+        for (auto style : {retro_dungeon::DungeonStyle::Rooms, retro_dungeon::DungeonStyle::Caves}) {
+            auto map = generator.generate(160, 120, style);
+            retro_dungeon::HierarchicalPathfinder hpa(16);
+            const auto [length, optimal] = requireValidPaths(*map, hpa, 6, 200);
+            REQUIRE(length * 100 <= optimal * 115);
+        }
+    }
+
+    SECTION("Start and goal in one cluster") {
+        retro_dungeon::Map map(40, 40);
+        map.fillRect(1, 1, 38, 38, retro_dungeon::TileType::Floor);
+        // A wall splitting the top-left cluster forces the path out and back.
+        map.fillRect(10, 0, 1, 20, retro_dungeon::TileType::Wall);
+        retro_dungeon::HierarchicalPathfinder hpa(20);
+        std::vector<retro_dungeon::Position> waypoints;
+        REQUIRE(hpa.findPath(map, {5, 5}, {15, 5}, waypoints));
+        REQUIRE(hpa.getPathLength() > 10);
+        REQUIRE(waypoints.size() > 1);
+        REQUIRE(hpa.findPath(map, {15, 5}, {16, 6}, waypoints));
+        REQUIRE(hpa.getPathLength() == 2);
+        REQUIRE(waypoints == std::vector<retro_dungeon::Position>{{16, 6}});
+        REQUIRE(hpa.findPath(map, {15, 5}, {15, 5}, waypoints));
+        REQUIRE(hpa.getPathLength() == 0);
+    }
+
+    SECTION("Unreachable goal") {
+        retro_dungeon::Map map(40, 20);
+        map.fillRect(1, 1, 15, 18, retro_dungeon::TileType::Floor);
+        map.fillRect(25, 1, 14, 18, retro_dungeon::TileType::Floor);
+        retro_dungeon::HierarchicalPathfinder hpa(8);
+        std::vector<retro_dungeon::Position> waypoints;
+        REQUIRE_FALSE(hpa.findPath(map, {2, 2}, {30, 10}, waypoints));
+        REQUIRE(waypoints.empty());
+        REQUIRE_FALSE(hpa.findPath(map, {0, 0}, {2, 2}, waypoints));
+    }
+}
+
+TEST_CASE("Hierarchical graph follows tile changes", "[hierarchical_pathfinder]") {
+    retro_dungeon::Map map(80, 40);
+    fillNoise(map, 80, 3);
+    retro_dungeon::HierarchicalPathfinder hpa(10);
+    hpa.sync(map);
+    REQUIRE(hpa.getRebuildCount() == 1);
+    REQUIRE(hpa.getClusterRebuildCount() == 0);
+
+    SECTION("A tile inside a cluster rebuilds only that cluster") {
+        map.setTile(15, 15, map.isWalkable(15, 15) ? retro_dungeon::TileType::Wall : retro_dungeon::TileType::Floor);
+        hpa.sync(map);
+        REQUIRE(hpa.getClusterRebuildCount() == 1);
+    }
+
+    SECTION("A tile on a border rebuilds both sides") {
+        map.setTile(19, 15, map.isWalkable(19, 15) ? retro_dungeon::TileType::Wall : retro_dungeon::TileType::Floor);
+        hpa.sync(map);
+        REQUIRE(hpa.getClusterRebuildCount() == 2);
+        map.setTile(20, 25, map.isWalkable(20, 25) ? retro_dungeon::TileType::Wall : retro_dungeon::TileType::Floor);
+        hpa.sync(map);
+        REQUIRE(hpa.getClusterRebuildCount() == 4);
+    }
+
+    SECTION("Patched graph answers like a fresh one") {
+        retro_dungeon::SplitMix64 rng(12);
+        std::vector<retro_dungeon::Position> waypoints;
+        for (int round = 0; round < 20; ++round) {
+            for (int i = 0; i < 5; ++i) {
+                const int x = retro_dungeon::uniformInt(rng, 1, map.getWidth() - 2);
+                const int y = retro_dungeon::uniformInt(rng, 1, map.getHeight() - 2);
+                map.setTile(x, y, map.isWalkable(x, y) ? retro_dungeon::TileType::Wall
+                                                       : retro_dungeon::TileType::Floor);
+            }
+            hpa.sync(map);
+            retro_dungeon::HierarchicalPathfinder fresh(10);
+            REQUIRE(fresh.getNodeCount() == 0);
+            fresh.sync(map);
+            REQUIRE(hpa.getNodeCount() == fresh.getNodeCount());
+            for (int q = 0; q < 10; ++q) {
+                const retro_dungeon::Position start{retro_dungeon::uniformInt(rng, 0, map.getWidth() - 1),
+                                                    retro_dungeon::uniformInt(rng, 0, map.getHeight() - 1)};
+                const retro_dungeon::Position goal{retro_dungeon::uniformInt(rng, 0, map.getWidth() - 1),
+                                                   retro_dungeon::uniformInt(rng, 0, map.getHeight() - 1)};
+                REQUIRE(hpa.findPath(map, start, goal, waypoints) == fresh.findPath(map, start, goal, waypoints));
+                REQUIRE(hpa.getPathLength() == fresh.getPathLength());
+            }
+        }
+        REQUIRE(hpa.getRebuildCount() == 1);
+        requireValidPaths(map, hpa, 9, 100);
+    }
+
+    SECTION("Bulk writes and other maps rebuild") {
+        map.clear();
+        map.fillRect(1, 1, 50, 20, retro_dungeon::TileType::Floor);
+        hpa.sync(map);
+        REQUIRE(hpa.getRebuildCount() == 2);
+
+        retro_dungeon::Map other(90, 30);
+        other.fillRect(1, 1, 50, 20, retro_dungeon::TileType::Floor);
+        std::vector<retro_dungeon::Position> waypoints;
+        REQUIRE(hpa.findPath(other, {1, 1}, {50, 20}, waypoints));
+        REQUIRE(hpa.getRebuildCount() == 3);
+        REQUIRE(hpa.getPathLength() == 68);
+    }
+}
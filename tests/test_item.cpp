@@ -0,0 +1,68 @@
+#include <catch2/catch_all.hpp>
+#include "retro_dungeon/item.hpp"
+#include <string>
+
+TEST_CASE("Item definitions are interned", "[item]") {
+    retro_dungeon::ItemStore items;
+    std::string name = "Health Potion";
+    const auto potion = items.define({name, retro_dungeon::ItemType::Potion, '!', 20, 0, 25});
+    name = "Overwritten";
+
+    REQUIRE(items.getDef(potion).name == "Health Potion");
+    REQUIRE(items.define({"Health Potion", retro_dungeon::ItemType::Potion, '!', 1}) == potion);
+    REQUIRE(items.getDefCount() == 1);
+    REQUIRE(items.getDef(potion).healAmount == 25);
+
+    const auto a = items.create(potion);
+    const auto b = items.create(potion);
+    REQUIRE(items.get(a) == items.get(b));
+    REQUIRE(items.get(a)->name.data() == items.getDef(potion).name.data());
+}
+
+TEST_CASE("Item handles", "[item]") {
+    retro_dungeon::ItemStore items;
+    const auto sword = items.define({"Sword", retro_dungeon::ItemType::Weapon, '/', 10, 5});
+    const auto handle = items.create(sword);
+
+    REQUIRE(handle.isValid());
+    REQUIRE(!retro_dungeon::INVALID_ITEM_HANDLE.isValid());
+    REQUIRE(!items.contains(retro_dungeon::INVALID_ITEM_HANDLE));
+    REQUIRE(items.get(handle)->damage == 5);
+    REQUIRE(items.size() == 1);
+
+    items.destroy(handle);
+    REQUIRE(items.size() == 0);
+    REQUIRE(items.get(handle) == nullptr);
+
+    const auto reused = items.create(sword);
+    REQUIRE(reused.index == handle.index);
+    REQUIRE(reused != handle);
+    REQUIRE(!items.contains(handle));
+    REQUIRE(items.contains(reused));
+}
+
+TEST_CASE("Inventory", "[item]") {
+    retro_dungeon::ItemStore items;
+    const auto coin = items.define({"Coin", retro_dungeon::ItemType::Gold, '$', 1});
+    retro_dungeon::Inventory inventory;
+
+    for (std::size_t i = 0; i < retro_dungeon::Inventory::CAPACITY; ++i) {
+        REQUIRE(inventory.add(items.create(coin)));
+    }
+    REQUIRE(inventory.full());
+    REQUIRE(!inventory.add(items.create(coin)));
+
+    const auto second = inventory[1];
+    const auto third = inventory[2];
+    REQUIRE(inventory.removeAt(1) == second);
+    REQUIRE(inventory[1] == third);
+    REQUIRE(inventory.size() == retro_dungeon::Inventory::CAPACITY - 1);
+    REQUIRE(inventory.removeAt(50) == retro_dungeon::INVALID_ITEM_HANDLE);
+
+    std::size_t count = 0;
+    for (auto item : inventory) {
+        REQUIRE(items.contains(item));
+        ++count;
+    }
+    REQUIRE(count == inventory.size());
+}
@@ -0,0 +1,163 @@
+#include <catch2/catch_all.hpp>
+#include "retro_dungeon/dungeon_generator.hpp"
+#include "retro_dungeon/jump_point_search.hpp"
+#include "retro_dungeon/pathfinder.hpp"
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+// Tiles open with probability `open` percent, inside a wall border.
+void fillNoise(retro_dungeon::Map& map, int open, uint64_t seed) {
+    retro_dungeon::SplitMix64 rng(seed);
+    for (int y = 1; y < map.getHeight() - 1; ++y) {
+        for (int x = 1; x < map.getWidth() - 1; ++x) {
+            if (static_cast<int>(rng() % 100) < open) map.setTile(x, y, retro_dungeon::TileType::Floor);
+        }
+    }
+}
+
+void requireSameAsAStar(const retro_dungeon::Map& map, uint64_t seed, int queries) {
+    retro_dungeon::Pathfinder astar;
+    retro_dungeon::JumpPointSearch jps;
+    std::vector<retro_dungeon::Position> expected;
+    std::vector<retro_dungeon::Position> path;
+    retro_dungeon::SplitMix64 rng(seed);
+
+    int found = 0;
+    for (int i = 0; i < queries; ++i) {
+        const retro_dungeon::Position start{retro_dungeon::uniformInt(rng, 0, map.getWidth() - 1),
+                                            retro_dungeon::uniformInt(rng, 0, map.getHeight() - 1)};
+        const retro_dungeon::Position goal{retro_dungeon::uniformInt(rng, 0, map.getWidth() - 1),
+                                           retro_dungeon::uniformInt(rng, 0, map.getHeight() - 1)};
+        const bool reachable = astar.findPath(map, start, goal, expected);
+        REQUIRE(jps.findPath(map, start, goal, path) == reachable);
+        REQUIRE(jps.getPathCost() == astar.getPathCost());
+        if (!reachable) {
+            REQUIRE(path.empty());
+            continue;
+        }
+
+        ++found;
+        REQUIRE(path.size() == expected.size());
+        retro_dungeon::Position prev = start;
+        for (const auto& p : path) {
+            REQUIRE(map.isWalkable(p.first, p.second));
+            REQUIRE(std::abs(p.first - prev.first) + std::abs(p.second - prev.second) == 1);
+            prev = p;
+        }
+        REQUIRE(prev == goal);
+    }
+    REQUIRE(found > 0);
+}
+
+void requireTablesMatchRebuild(const retro_dungeon::Map& map, const retro_dungeon::JumpPointSearch& jps) {
+    retro_dungeon::JumpPointSearch fresh;
+    fresh.sync(map);
+    for (int y = 0; y < map.getHeight(); ++y) {
+        for (int x = 0; x < map.getWidth(); ++x) {
+            if (!map.isWalkable(x, y)) continue;
+            for (auto dir : {retro_dungeon::Direction::North, retro_dungeon::Direction::South,
+                             retro_dungeon::Direction::East, retro_dungeon::Direction::West}) {
+                REQUIRE(jps.jumpDistance(x, y, dir) == fresh.jumpDistance(x, y, dir));
+            }
+        }
+    }
+}
+
+}
+
+TEST_CASE("Jump point search finds A*-optimal paths", "[jump_point_search]") {
+    SECTION("Noise maps") {
+        for (int open : {55, 70, 85}) {
+            retro_dungeon::Map map(70, 40);
+            fillNoise(map, open, static_cast<uint64_t>(open));
+            requireSameAsAStar(map, 5, 400);
+        }
+    }
+
+    SECTION("Generated levels") {
+        retro_dungeon::DungeonGenerator generator(8);
+        requireSameAsAStar(*generator.generate(128, 96, retro_dungeon::DungeonStyle::Rooms), 6, 200);
+        requireSameAsAStar(*generator.generate(128, 96, retro_dungeon::DungeonStyle::Caves), 7, 200);
+    }
+
+    SECTION("Open room expands far fewer tiles than A*") {
+        retro_dungeon::Map map(64, 64);
+        map.fillRect(1, 1, 62, 62, retro_dungeon::TileType::Floor);
+        map.fillRect(20, 10, 20, 30, retro_dungeon::TileType::Wall);
+        retro_dungeon::Pathfinder astar;
+        retro_dungeon::JumpPointSearch jps;
+        std::vector<retro_dungeon::Position> path;
+        REQUIRE(astar.findPath(map, {30, 5}, {30, 50}, path));
+        REQUIRE(jps.findPath(map, {30, 5}, {30, 50}, path));
+        REQUIRE(jps.getPathCost() == astar.getPathCost());
+        REQUIRE(jps.getExpandedCount() * 10 < astar.getExpandedCount());
+    }
+}
+
+TEST_CASE("Jump tables follow tile changes", "[jump_point_search]") {
+    retro_dungeon::Map map(90, 30);
+    fillNoise(map, 75, 3);
+    retro_dungeon::JumpPointSearch jps;
+    std::vector<retro_dungeon::Position> path;
+    jps.sync(map);
+    REQUIRE(jps.getRebuildCount() == 1);
+
+    SECTION("setTile patches in place") {
+        retro_dungeon::SplitMix64 rng(12);
+        for (int round = 0; round < 20; ++round) {
+            for (int i = 0; i < 5; ++i) {
+                const int x = retro_dungeon::uniformInt(rng, 1, map.getWidth() - 2);
+                const int y = retro_dungeon::uniformInt(rng, 1, map.getHeight() - 2);
+                map.setTile(x, y, map.isWalkable(x, y) ? retro_dungeon::TileType::Wall
+                                                       : retro_dungeon::TileType::Floor);
+            }
+            jps.findPath(map, {1, 1}, {88, 28}, path);
+            requireTablesMatchRebuild(map, jps);
+        }
+        REQUIRE(jps.getRebuildCount() == 1);
+        REQUIRE(jps.getPatchedTileCount() > 0);
+        requireSameAsAStar(map, 9, 100);
+    }
+
+    SECTION("Bulk writes and other maps rebuild") {
+        map.clear();
+        map.fillRect(1, 1, 50, 20, retro_dungeon::TileType::Floor);
+        jps.sync(map);
+        REQUIRE(jps.getRebuildCount() == 2);
+        requireTablesMatchRebuild(map, jps);
+
+        retro_dungeon::Map other(90, 30);
+        other.fillRect(1, 1, 50, 20, retro_dungeon::TileType::Floor);
+        jps.sync(other);
+        REQUIRE(jps.getRebuildCount() == 3);
+        REQUIRE(jps.findPath(other, {1, 1}, {50, 20}, path));
+    }
+}
+
+TEST_CASE("Jump point search refuses maps its tables cannot hold", "[jump_point_search]") {
+    constexpr int SIDE = retro_dungeon::JumpPointSearch::MAX_SIDE;
+    retro_dungeon::JumpPointSearch jps;
+    std::vector<retro_dungeon::Position> path;
+
+    retro_dungeon::Map widest(SIDE, 3);
+    widest.fillRect(0, 1, SIDE, 1, retro_dungeon::TileType::Floor);
+    REQUIRE(jps.sync(widest));
+    REQUIRE(jps.jumpDistance(0, 1, retro_dungeon::Direction::East) == -(SIDE - 1));
+    REQUIRE(jps.findPath(widest, {0, 1}, {SIDE - 1, 1}, path));
+    REQUIRE(jps.getPathCost() == (SIDE - 1) * retro_dungeon::Pathfinder::STRAIGHT_COST);
+
+    retro_dungeon::Map tooWide(SIDE + 1, 3);
+    tooWide.fillRect(0, 1, SIDE + 1, 1, retro_dungeon::TileType::Floor);
+    REQUIRE(!jps.sync(tooWide));
+    REQUIRE(!jps.findPath(tooWide, {0, 1}, {SIDE, 1}, path));
+    REQUIRE(path.empty());
+
+    retro_dungeon::Map tooTall(3, SIDE + 1);
+    tooTall.fillRect(1, 0, 1, SIDE + 1, retro_dungeon::TileType::Floor);
+    REQUIRE(!jps.findPath(tooTall, {1, 0}, {1, SIDE}, path));
+
+    REQUIRE(jps.findPath(widest, {0, 1}, {SIDE - 1, 1}, path));
+    REQUIRE(path.size() == static_cast<std::size_t>(SIDE - 1));
+}
@@ -0,0 +1,61 @@
+#include <catch2/catch_all.hpp>
+#include "retro_dungeon/level_arena.hpp"
+#include <memory_resource>
+#include <vector>
+
+namespace {
+
+// Stands in for the heap behind an arena and counts what reaches it.
+struct CountingResource : std::pmr::memory_resource {
+    std::size_t allocations = 0;
+    std::size_t deallocations = 0;
+
+    void* do_allocate(std::size_t size, std::size_t alignment) override {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(size, alignment);
+    }
+    void do_deallocate(void* p, std::size_t size, std::size_t alignment) override {
+        ++deallocations;
+        std::pmr::new_delete_resource()->deallocate(p, size, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+}
+
+TEST_CASE("Level arena", "[arena]") {
+    CountingResource heap;
+    retro_dungeon::LevelArena arena(1024, &heap);
+
+    struct Pair {
+        int a;
+        int b;
+    };
+    Pair* first = arena.create<Pair>(1, 2);
+    REQUIRE(first->b == 2);
+    arena.create<Pair>(3, 4);
+    REQUIRE(arena.getAllocationCount() == 2);
+    REQUIRE(arena.getBytesAllocated() == 2 * sizeof(Pair));
+
+    SECTION("Reset rewinds to the start of the block") {
+        arena.reset();
+        REQUIRE(arena.getAllocationCount() == 0);
+        REQUIRE(arena.getResetCount() == 1);
+        REQUIRE(arena.create<Pair>(5, 6) == first);
+        REQUIRE(arena.getUpstreamAllocationCount() == 0);
+        REQUIRE(heap.allocations == 0);
+    }
+
+    SECTION("Overflow is served by the heap and counted") {
+        std::pmr::vector<char> big(4096, 'x', &arena);
+        REQUIRE(arena.getUpstreamAllocationCount() == 1);
+        REQUIRE(arena.getUpstreamBytes() >= 4096);
+        REQUIRE(heap.allocations == 1);
+
+        big = std::pmr::vector<char>(&arena);
+        arena.reset();
+        REQUIRE(heap.deallocations == 1);
+    }
+}
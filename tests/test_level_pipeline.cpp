@@ -0,0 +1,70 @@
+#include <catch2/catch_all.hpp>
+#include "retro_dungeon/dungeon_generator.hpp"
+#include "retro_dungeon/level_pipeline.hpp"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace {
+
+bool sameLayout(const retro_dungeon::Map& a, const retro_dungeon::Map& b) {
+    if (a.getWidth() != b.getWidth() || a.getHeight() != b.getHeight()) return false;
+    if (a.getStairsDown() != b.getStairsDown()) return false;
+    for (int y = 0; y < a.getHeight(); ++y) {
+        auto rowA = a.typeRow(y);
+        auto rowB = b.typeRow(y);
+        if (!std::equal(rowA.begin(), rowA.end(), rowB.begin(), rowB.end())) return false;
+    }
+    return true;
+}
+
+bool waitUntilReady(const retro_dungeon::LevelPipeline& pipeline, int level) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!pipeline.isReady(level)) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+}
+
+TEST_CASE("Level seeds depend only on master seed and level", "[level_pipeline]") {
+    using retro_dungeon::DungeonGenerator;
+
+    REQUIRE(DungeonGenerator::levelSeed(42, 3) == DungeonGenerator::levelSeed(42, 3));
+    REQUIRE(DungeonGenerator::levelSeed(42, 3) != DungeonGenerator::levelSeed(42, 4));
+    REQUIRE(DungeonGenerator::levelSeed(42, 3) != DungeonGenerator::levelSeed(43, 3));
+}
+
+TEST_CASE("Pre-generated levels match on-demand levels", "[level_pipeline]") {
+    retro_dungeon::LevelPipeline pipeline(1234, 60, 20, 2, 2);
+    retro_dungeon::LevelPipeline reference(1234, 60, 20, 1, 1);
+
+    auto first = pipeline.acquire(1);
+    REQUIRE(pipeline.getMissCount() == 1);
+    REQUIRE(sameLayout(*first, *reference.generateLevel(1)));
+
+    REQUIRE(waitUntilReady(pipeline, 2));
+    auto second = pipeline.acquire(2);
+    REQUIRE(pipeline.getHitCount() == 1);
+    REQUIRE(sameLayout(*second, *reference.generateLevel(2)));
+
+    REQUIRE(waitUntilReady(pipeline, 3));
+    REQUIRE(waitUntilReady(pipeline, 4));
+    auto fourth = pipeline.acquire(4);
+    REQUIRE(sameLayout(*fourth, *reference.generateLevel(4)));
+}
+
+TEST_CASE("Pipeline falls back when levels are skipped", "[level_pipeline]") {
+    retro_dungeon::LevelPipeline pipeline(99, 60, 20, 2, 1);
+    retro_dungeon::LevelPipeline reference(99, 60, 20, 1, 1);
+
+    pipeline.acquire(1);
+    auto far = pipeline.acquire(10);
+    REQUIRE(far != nullptr);
+    REQUIRE(sameLayout(*far, *reference.generateLevel(10)));
+
+    auto back = pipeline.acquire(2);
+    REQUIRE(sameLayout(*back, *reference.generateLevel(2)));
+}
@@ -0,0 +1,107 @@
+#include <catch2/catch_all.hpp>
+#include "retro_dungeon/line_of_sight.hpp"
+#include "retro_dungeon/random.hpp"
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+// Tiles open with probability `open` percent, inside a wall border.
+void fillNoise(retro_dungeon::Map& map, int open, uint64_t seed) {
+    retro_dungeon::SplitMix64 rng(seed);
+    for (int y = 1; y < map.getHeight() - 1; ++y) {
+        for (int x = 1; x < map.getWidth() - 1; ++x) {
+            if (static_cast<int>(rng() % 100) < open) map.setTile(x, y, retro_dungeon::TileType::Floor);
+        }
+    }
+}
+
+// Reference: walk the Bresenham line from a to b.
+bool walkLine(const retro_dungeon::Map& map, retro_dungeon::Position a, retro_dungeon::Position b) {
+    const int dx = std::abs(b.first - a.first);
+    const int dy = -std::abs(b.second - a.second);
+    const int sx = a.first < b.first ? 1 : -1;
+    const int sy = a.second < b.second ? 1 : -1;
+    int err = dx + dy;
+    while (a != b) {
+        const int twice = 2 * err;
+        if (twice >= dy) {
+            err += dy;
+            a.first += sx;
+        }
+        if (twice <= dx) {
+            err += dx;
+            a.second += sy;
+        }
+        if (a != b && !map.isWalkable(a.first, a.second)) return false;
+    }
+    return true;
+}
+
+}
+
+TEST_CASE("Line of sight", "[line_of_sight]") {
+    retro_dungeon::LineOfSight sight;
+
+    SECTION("Walls between the two block sight") {
+        retro_dungeon::Map map(40, 20);
+        map.fillRect(1, 1, 38, 18, retro_dungeon::TileType::Floor);
+        map.setTile(10, 10, retro_dungeon::TileType::Wall);
+        REQUIRE(sight.canSee(map, {5, 10}, {15, 10}) == false);
+        REQUIRE(sight.canSee(map, {5, 9}, {15, 9}));
+        REQUIRE(sight.canSee(map, {9, 10}, {10, 10}));
+        REQUIRE(sight.canSee(map, {10, 10}, {10, 10}));
+        REQUIRE(sight.canSee(map, {5, 5}, {5, 5}));
+        // Too far apart for the window: the line is walked instead.
+        REQUIRE(sight.canSee(map, {1, 10}, {38, 10}) == false);
+        REQUIRE(sight.canSee(map, {1, 11}, {38, 11}));
+    }
+
+    SECTION("Bitboard answers match walking the line") {
+        for (int open : {55, 75, 90}) {
+            retro_dungeon::Map map(100, 60);
+            fillNoise(map, open, static_cast<uint64_t>(open));
+            retro_dungeon::SplitMix64 rng(4);
+            std::vector<retro_dungeon::Position> observers;
+            std::vector<retro_dungeon::Position> targets;
+            for (int i = 0; i < 4000; ++i) {
+                const retro_dungeon::Position target{retro_dungeon::uniformInt(rng, 0, map.getWidth() - 1),
+                                                     retro_dungeon::uniformInt(rng, 0, map.getHeight() - 1)};
+                const int reach = i % 4 == 0 ? 40 : retro_dungeon::LineOfSight::RANGE;
+                for (int j = 0; j < 3; ++j) {
+                    targets.push_back(target);
+                    observers.push_back({target.first + retro_dungeon::uniformInt(rng, -reach, reach),
+                                         target.second + retro_dungeon::uniformInt(rng, -reach, reach)});
+                }
+            }
+            std::vector<uint8_t> results(observers.size());
+            sight.canSee(map, observers, targets, results);
+            int seen = 0;
+            for (std::size_t i = 0; i < observers.size(); ++i) {
+                REQUIRE((results[i] != 0) == walkLine(map, observers[i], targets[i]));
+                seen += results[i];
+            }
+            REQUIRE(seen > 0);
+            REQUIRE(seen < static_cast<int>(observers.size()));
+        }
+    }
+
+    SECTION("One window serves every observer until the map changes") {
+        retro_dungeon::Map map(60, 40);
+        fillNoise(map, 80, 9);
+        std::vector<retro_dungeon::Position> observers;
+        for (int x = 15; x < 45; ++x) observers.push_back({x, 12});
+        std::vector<uint8_t> results(observers.size());
+        sight.canSee(map, observers, {30, 20}, results);
+        sight.canSee(map, observers, {30, 20}, results);
+        REQUIRE(sight.getWindowBuildCount() == 1);
+
+        map.setTile(30, 16, retro_dungeon::TileType::Wall);
+        sight.canSee(map, observers, {30, 20}, results);
+        REQUIRE(sight.getWindowBuildCount() == 2);
+        for (std::size_t i = 0; i < observers.size(); ++i) {
+            REQUIRE((results[i] != 0) == walkLine(map, observers[i], {30, 20}));
+        }
+        REQUIRE(results[15] == 0);
+    }
+}
@@ -1,5 +1,8 @@
 #include <catch2/catch_all.hpp>
 #include "retro_dungeon/game.hpp"
+#include <algorithm>
+#include <utility>
+#include <vector>
 
 TEST_CASE("Map creation", "[map]") {
     retro_dungeon::Map map(60, 20);
@@ -51,4 +54,217 @@ TEST_CASE("Map clear", "[map]") {
     map.clear();
     
     REQUIRE(map.getTile(10, 10).type == retro_dungeon::TileType::Wall);
-}
\ No newline at end of file
+}
+TEST_CASE("Map rows are contiguous", "[map]") {
+    retro_dungeon::Map map(60, 20);
+
+    SECTION("Rows are padded to whole bitplane words") {
+        REQUIRE(map.getStride() == 64);
+        REQUIRE(map.getWordsPerRow() == 1);
+        REQUIRE(map.walkableRow(19).size() == 1);
+    }
+
+    SECTION("Type rows cover the map width") {
+        map.setTile(59, 3, retro_dungeon::TileType::Door);
+        auto row = map.typeRow(3);
+        REQUIRE(row.size() == 60);
+        REQUIRE(row[59] == retro_dungeon::TileType::Door);
+    }
+}
+
+TEST_CASE("Map bitplanes", "[map]") {
+    retro_dungeon::Map map(130, 4);
+
+    SECTION("Walkability follows the tile type") {
+        map.setTile(70, 2, retro_dungeon::TileType::Trap);
+        REQUIRE(map.walkableRow(2)[1] == (uint64_t{1} << 6));
+        map.setTile(70, 2, retro_dungeon::TileType::Wall);
+        REQUIRE(map.walkableRow(2)[1] == 0);
+    }
+
+    SECTION("Counts run across word boundaries") {
+        map.fillRect(60, 1, 10, 2, retro_dungeon::TileType::Floor);
+        REQUIRE(map.countWalkable() == 20);
+    }
+
+    SECTION("Visible tiles are explored and then cleared") {
+        map.setVisible(1, 1, true);
+        map.setVisible(129, 3, true);
+        map.exploreVisible();
+        map.clearVisible();
+        REQUIRE(map.countVisible() == 0);
+        REQUIRE(map.countExplored() == 2);
+        REQUIRE(map.getTile(129, 3).explored);
+        REQUIRE(!map.getTile(129, 3).visible);
+    }
+
+    SECTION("Visibility can be cleared and explored by rectangle") {
+        map.setVisible(1, 1, true);
+        map.setVisible(62, 2, true);
+        map.setVisible(66, 2, true);
+        map.setVisible(129, 3, true);
+        map.exploreVisible(64, 0, 10, 4);
+        REQUIRE(map.countExplored() == 1);
+        REQUIRE(map.isExplored(66, 2));
+        map.clearVisible(60, -5, 200, 10);
+        REQUIRE(map.countVisible() == 1);
+        REQUIRE(map.isVisible(1, 1));
+    }
+}
+
+TEST_CASE("Map fillRect", "[map]") {
+    retro_dungeon::Map map(60, 20);
+
+    SECTION("Fills the rectangle") {
+        map.fillRect(5, 5, 3, 2, retro_dungeon::TileType::Floor);
+        REQUIRE(map.isWalkable(5, 5));
+        REQUIRE(map.isWalkable(7, 6));
+        REQUIRE(!map.isWalkable(8, 6));
+        REQUIRE(!map.isWalkable(5, 7));
+    }
+
+    SECTION("Clips to the map bounds") {
+        map.fillRect(55, 15, 20, 20, retro_dungeon::TileType::Floor);
+        REQUIRE(map.isWalkable(59, 19));
+        REQUIRE(!map.isWalkable(54, 19));
+    }
+}
+
+TEST_CASE("Map assignRow", "[map]") {
+    retro_dungeon::Map map(70, 3);
+    const uint64_t mask[2] = {0b1011, ~uint64_t{0}};
+
+    map.assignRow(1, mask, retro_dungeon::TileType::Floor, retro_dungeon::TileType::Wall);
+
+    REQUIRE(map.getTileType(0, 1) == retro_dungeon::TileType::Floor);
+    REQUIRE(map.getTileType(2, 1) == retro_dungeon::TileType::Wall);
+    REQUIRE(map.isWalkable(3, 1));
+    REQUIRE(!map.isWalkable(4, 1));
+    REQUIRE(map.isWalkable(69, 1));
+    REQUIRE(map.countWalkable() == 3 + 6);
+}
+
+TEST_CASE("Map walkable cell list", "[map]") {
+    retro_dungeon::Map map(100, 12);
+    map.fillRect(2, 2, 10, 3, retro_dungeon::TileType::Floor);
+    REQUIRE(map.walkableCells().empty());
+
+    auto matchesPlane = [&] {
+        std::vector<uint32_t> cells(map.walkableCells().begin(), map.walkableCells().end());
+        std::sort(cells.begin(), cells.end());
+        std::vector<uint32_t> expected;
+        for (int y = 0; y < map.getHeight(); ++y) {
+            for (int x = 0; x < map.getWidth(); ++x) {
+                if (map.isWalkable(x, y)) {
+                    expected.push_back(static_cast<uint32_t>(y * map.getStride() + x));
+                }
+            }
+        }
+        return cells == expected;
+    };
+
+    map.trackWalkableCells();
+    REQUIRE(map.isTrackingWalkableCells());
+    REQUIRE(map.walkableCells().size() == 30);
+    REQUIRE(matchesPlane());
+
+    map.setTile(3, 3, retro_dungeon::TileType::Wall);
+    map.setTile(90, 10, retro_dungeon::TileType::Door);
+    map.setTile(91, 10, retro_dungeon::TileType::Wall);
+    REQUIRE(matchesPlane());
+
+    map.fillRect(50, 0, 40, 12, retro_dungeon::TileType::Floor);
+    map.fillRect(60, 4, 5, 5, retro_dungeon::TileType::Wall);
+    REQUIRE(matchesPlane());
+
+    const uint64_t mask[2] = {0xf0f0f0f0f0f0f0f0, ~uint64_t{0}};
+    map.assignRow(7, mask, retro_dungeon::TileType::Floor, retro_dungeon::TileType::Wall);
+    REQUIRE(matchesPlane());
+
+    const auto cell = map.walkableCells().front();
+    const auto [x, y] = map.cellPosition(cell);
+    REQUIRE(map.isWalkable(x, y));
+
+    map.clear();
+    REQUIRE(map.walkableCells().empty());
+    map.setTile(1, 1, retro_dungeon::TileType::Floor);
+    REQUIRE(map.walkableCells().size() == 1);
+}
+
+TEST_CASE("Map walkability journal", "[map]") {
+    retro_dungeon::Map map(80, 10);
+    retro_dungeon::Map other(80, 10);
+    REQUIRE(map.getRevision() != other.getRevision());
+
+    std::vector<retro_dungeon::Position> changes;
+    auto collect = [&](uint64_t revision) {
+        changes.clear();
+        return map.forEachChangeSince(revision, [&](retro_dungeon::Position p) { changes.push_back(p); });
+    };
+
+    const uint64_t start = map.getRevision();
+    REQUIRE(collect(start));
+    REQUIRE(changes.empty());
+
+    map.setTile(3, 4, retro_dungeon::TileType::Floor);
+    map.setTile(3, 4, retro_dungeon::TileType::Door);  // still walkable: not a change
+    map.fillRect(70, 1, 2, 1, retro_dungeon::TileType::Floor);
+    REQUIRE(map.getRevision() == start + 3);
+    REQUIRE(collect(start));
+    REQUIRE(changes == std::vector<retro_dungeon::Position>{{3, 4}, {70, 1}, {71, 1}});
+    REQUIRE(collect(start + 2));
+    REQUIRE(changes == std::vector<retro_dungeon::Position>{{71, 1}});
+
+    SECTION("Revisions of another map are rejected") {
+        REQUIRE(!collect(other.getRevision()));
+        REQUIRE(!collect(map.getRevision() + 1));
+    }
+
+    SECTION("Bulk writes are not itemised") {
+        const uint64_t mask[2] = {~uint64_t{0}, 0};
+        map.assignRow(2, mask, retro_dungeon::TileType::Floor, retro_dungeon::TileType::Wall);
+        REQUIRE(!collect(start));
+        const uint64_t afterBulk = map.getRevision();
+        map.setTile(5, 5, retro_dungeon::TileType::Floor);
+        REQUIRE(collect(afterBulk));
+        REQUIRE(changes.size() == 1);
+    }
+
+    SECTION("Only the newest changes are kept") {
+        map.fillRect(0, 0, 80, 10, retro_dungeon::TileType::Floor);
+        map.fillRect(0, 0, 80, 10, retro_dungeon::TileType::Wall);
+        REQUIRE(map.getRevision() - start > retro_dungeon::Map::CHANGE_LOG_CAPACITY);
+        REQUIRE(!collect(start));
+        REQUIRE(collect(map.getRevision() - retro_dungeon::Map::CHANGE_LOG_CAPACITY));
+        REQUIRE(changes.size() == retro_dungeon::Map::CHANGE_LOG_CAPACITY);
+    }
+}
+
+TEST_CASE("Map move leaves the source empty", "[map]") {
+    retro_dungeon::Map source(80, 10);
+    source.fillRect(2, 2, 10, 5, retro_dungeon::TileType::Floor);
+    const uint64_t revision = source.getRevision();
+
+    retro_dungeon::Map moved(std::move(source));
+    REQUIRE(moved.getWidth() == 80);
+    REQUIRE(moved.isWalkable(5, 5));
+    REQUIRE(moved.countWalkable() == 50);
+    REQUIRE(moved.getRevision() == revision);
+
+    REQUIRE(source.getWidth() == 0);
+    REQUIRE(source.getHeight() == 0);
+    REQUIRE(!source.isWalkable(5, 5));
+    REQUIRE(source.countWalkable() == 0);
+    REQUIRE(source.getRevision() != revision);
+
+    retro_dungeon::Map assigned(4, 4);
+    assigned = std::move(moved);
+    REQUIRE(assigned.getTileType(5, 5) == retro_dungeon::TileType::Floor);
+    REQUIRE(moved.getWidth() == 0);
+    REQUIRE(moved.countWalkable() == 0);
+
+    source = std::move(assigned);
+    REQUIRE(source.isWalkable(11, 6));
+    source.setTile(20, 8, retro_dungeon::TileType::Floor);
+    REQUIRE(source.countWalkable() == 51);
+}
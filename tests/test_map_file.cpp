@@ -0,0 +1,186 @@
+#include <catch2/catch_all.hpp>
+#include "retro_dungeon/map_file.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string>
+
+namespace {
+
+retro_dungeon::Map makeLevel() {
+    retro_dungeon::Map map(100, 30);
+    map.fillRect(10, 5, 70, 20, retro_dungeon::TileType::Floor);
+    map.setTile(99, 29, retro_dungeon::TileType::Door);
+    map.setTile(40, 12, retro_dungeon::TileType::StairsDown);
+    map.setStairsDown({40, 12});
+    map.setSpawnPoint({12, 6});
+    return map;
+}
+
+// Rewrites `filename` after letting `edit` change its bytes in place.
+template <typename Edit>
+void corruptFile(const char* filename, Edit edit) {
+    std::string bytes;
+    {
+        std::ifstream in(filename, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    retro_dungeon::MapFileHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    edit(header, bytes);
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+}
+
+TEST_CASE("Map file roundtrip", "[map_file]") {
+    const char* filename = "test_level.rdmap";
+    retro_dungeon::Map original = makeLevel();
+    REQUIRE(retro_dungeon::saveMapFile(original, filename));
+
+    auto loaded = retro_dungeon::openMapFile(filename);
+    REQUIRE(loaded != nullptr);
+
+    SECTION("Layers and header fields match") {
+        REQUIRE(loaded->isMapped());
+        REQUIRE(loaded->getWidth() == 100);
+        REQUIRE(loaded->getHeight() == 30);
+        REQUIRE(loaded->getStairsDown() == retro_dungeon::Position{40, 12});
+        REQUIRE(loaded->getSpawnPoint() == retro_dungeon::Position{12, 6});
+        REQUIRE(loaded->countWalkable() == original.countWalkable());
+        REQUIRE(retro_dungeon::verifyMapLayers(*loaded));
+        for (int y = 0; y < original.getHeight(); ++y) {
+            auto expected = original.typeRow(y);
+            auto actual = loaded->typeRow(y);
+            REQUIRE(std::equal(expected.begin(), expected.end(), actual.begin(), actual.end()));
+        }
+    }
+
+    SECTION("Modifying a loaded map leaves the file untouched") {
+        loaded->setTile(10, 5, retro_dungeon::TileType::Wall);
+        loaded->clear();
+        REQUIRE(!loaded->isWalkable(40, 12));
+
+        auto reloaded = retro_dungeon::openMapFile(filename);
+        REQUIRE(reloaded != nullptr);
+        REQUIRE(reloaded->isWalkable(10, 5));
+        REQUIRE(reloaded->getTileType(40, 12) == retro_dungeon::TileType::StairsDown);
+    }
+
+    loaded.reset();
+    std::remove(filename);
+}
+
+TEST_CASE("Map file rejects bad input", "[map_file]") {
+    SECTION("Missing file") {
+        REQUIRE(retro_dungeon::openMapFile("nonexistent.rdmap") == nullptr);
+    }
+
+    SECTION("Wrong magic") {
+        const char* filename = "bad_magic.rdmap";
+        {
+            std::ofstream file(filename, std::ios::binary);
+            file << "this is not a map file, just some text that is long enough for a header";
+        }
+        REQUIRE(retro_dungeon::openMapFile(filename) == nullptr);
+        std::remove(filename);
+    }
+
+    SECTION("Truncated layers") {
+        const char* filename = "truncated.rdmap";
+        REQUIRE(retro_dungeon::saveMapFile(makeLevel(), filename));
+        {
+            std::ifstream in(filename, std::ios::binary);
+            std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+            out.write(bytes.data(), static_cast<std::streamsize>(bytes.size() / 2));
+        }
+        REQUIRE(retro_dungeon::openMapFile(filename) == nullptr);
+        std::remove(filename);
+    }
+
+    SECTION("Header offsets that wrap around") {
+        const char* filename = "wrapping.rdmap";
+        retro_dungeon::MapFileHeader header{};
+        std::memcpy(header.magic, retro_dungeon::MAP_FILE_MAGIC, sizeof(header.magic));
+        header.version = retro_dungeon::MAP_FILE_VERSION;
+        header.headerSize = sizeof(header);
+        header.width = 10;
+        header.height = 2;
+        header.stride = 64;
+        header.typeOffset = ~uint64_t{0} - 63;
+        header.walkableOffset = 64;
+        header.fileSize = 80;
+        {
+            std::string bytes(136, '\0');
+            std::memcpy(bytes.data(), &header, sizeof(header));
+            std::ofstream out(filename, std::ios::binary);
+            out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        }
+        REQUIRE(retro_dungeon::openMapFile(filename) == nullptr);
+
+        corruptFile(filename, [](retro_dungeon::MapFileHeader& bad, std::string& bytes) {
+            bad.width = std::numeric_limits<int32_t>::max();
+            bad.stride = std::numeric_limits<int32_t>::min();
+            bad.typeOffset = 64;
+            std::memcpy(bytes.data(), &bad, sizeof(bad));
+        });
+        REQUIRE(retro_dungeon::openMapFile(filename) == nullptr);
+        std::remove(filename);
+    }
+
+    SECTION("Stairs or spawn off the map or inside a wall") {
+        const char* filename = "bad_points.rdmap";
+        const auto expectRejected = [&](auto edit) {
+            REQUIRE(retro_dungeon::saveMapFile(makeLevel(), filename));
+            corruptFile(filename, [&](retro_dungeon::MapFileHeader& header, std::string& bytes) {
+                edit(header);
+                std::memcpy(bytes.data(), &header, sizeof(header));
+            });
+            REQUIRE(retro_dungeon::openMapFile(filename) == nullptr);
+        };
+        expectRejected([](retro_dungeon::MapFileHeader& header) { header.stairsX = 100; });
+        expectRejected([](retro_dungeon::MapFileHeader& header) { header.spawnY = -1; });
+        expectRejected([](retro_dungeon::MapFileHeader& header) {
+            header.spawnX = 0;
+            header.spawnY = 0;
+        });
+        std::remove(filename);
+    }
+}
+
+TEST_CASE("Map file layers are verified only on request", "[map_file]") {
+    const char* filename = "unverified.rdmap";
+    REQUIRE(retro_dungeon::saveMapFile(makeLevel(), filename));
+
+    SECTION("Tile type outside the trait table reads as a wall") {
+        corruptFile(filename, [](const retro_dungeon::MapFileHeader& header, std::string& bytes) {
+            bytes[header.typeOffset + 10 * header.stride + 20] =
+                static_cast<char>(retro_dungeon::TILE_TRAITS.size());
+        });
+        auto loaded = retro_dungeon::openMapFile(filename);
+        REQUIRE(loaded != nullptr);
+        REQUIRE(loaded->getTile(20, 10).symbol == '#');
+        REQUIRE(!loaded->getTile(20, 10).walkable);
+        REQUIRE(!retro_dungeon::verifyMapLayers(*loaded));
+    }
+
+    SECTION("Walkable bits past the width") {
+        corruptFile(filename, [](const retro_dungeon::MapFileHeader& header, std::string& bytes) {
+            // Row 3, second word: tile 100 of a 100-wide map.
+            const std::size_t offset = header.walkableOffset + (3 * (header.stride / 64) + 1) * 8;
+            uint64_t word;
+            std::memcpy(&word, bytes.data() + offset, sizeof(word));
+            word |= uint64_t{1} << (100 - 64);
+            std::memcpy(bytes.data() + offset, &word, sizeof(word));
+        });
+        auto loaded = retro_dungeon::openMapFile(filename);
+        REQUIRE(loaded != nullptr);
+        REQUIRE(!retro_dungeon::verifyMapLayers(*loaded));
+    }
+
+    std::remove(filename);
+}
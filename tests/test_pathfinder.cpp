@@ -0,0 +1,98 @@
+#include <catch2/catch_all.hpp>
+#include "retro_dungeon/pathfinder.hpp"
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+void requireValidPath(const retro_dungeon::Map& map, retro_dungeon::Position start,
+                      retro_dungeon::Position goal, const std::vector<retro_dungeon::Position>& path) {
+    REQUIRE(!path.empty());
+    REQUIRE(path.back() == goal);
+    retro_dungeon::Position prev = start;
+    for (const auto& p : path) {
+        REQUIRE(map.isWalkable(p.first, p.second));
+        REQUIRE(std::abs(p.first - prev.first) <= 1);
+        REQUIRE(std::abs(p.second - prev.second) <= 1);
+        REQUIRE(p != prev);
+        prev = p;
+    }
+}
+
+}
+
+TEST_CASE("A* pathfinding", "[pathfinder]") {
+    retro_dungeon::Map map(70, 20);
+    map.fillRect(1, 1, 68, 18, retro_dungeon::TileType::Floor);
+    retro_dungeon::Pathfinder pathfinder;
+    std::vector<retro_dungeon::Position> path;
+
+    SECTION("Open floor takes the Manhattan distance") {
+        REQUIRE(pathfinder.findPath(map, {2, 2}, {66, 17}, path));
+        requireValidPath(map, {2, 2}, {66, 17}, path);
+        REQUIRE(path.size() == 64 + 15);
+        REQUIRE(pathfinder.getPathCost() == 79 * retro_dungeon::Pathfinder::STRAIGHT_COST);
+    }
+
+    SECTION("Walls force a detour") {
+        // A wall from the top down to y = 16 with a gap only at the bottom.
+        map.fillRect(30, 1, 1, 16, retro_dungeon::TileType::Wall);
+        REQUIRE(pathfinder.findPath(map, {29, 2}, {31, 2}, path));
+        requireValidPath(map, {29, 2}, {31, 2}, path);
+        REQUIRE(path.size() == 2 + 15 * 2);
+    }
+
+    SECTION("Unreachable and blocked endpoints fail with an empty path") {
+        map.fillRect(30, 1, 1, 18, retro_dungeon::TileType::Wall);
+        path.push_back({1, 1});
+        REQUIRE(!pathfinder.findPath(map, {29, 2}, {31, 2}, path));
+        REQUIRE(path.empty());
+        REQUIRE(pathfinder.getPathCost() == -1);
+        REQUIRE(!pathfinder.findPath(map, {29, 2}, {30, 2}, path));
+        REQUIRE(!pathfinder.findPath(map, {0, 0}, {29, 2}, path));
+    }
+
+    SECTION("Start equals goal") {
+        REQUIRE(pathfinder.findPath(map, {5, 5}, {5, 5}, path));
+        REQUIRE(path.empty());
+        REQUIRE(pathfinder.getPathCost() == 0);
+    }
+
+    SECTION("Expansion limit gives up on long searches") {
+        REQUIRE(!pathfinder.findPath(map, {2, 2}, {66, 17}, path, 10));
+        REQUIRE(pathfinder.getExpandedCount() == 10);
+        REQUIRE(pathfinder.findPath(map, {2, 2}, {4, 2}, path, 10));
+    }
+
+    SECTION("Reused state gives the same answers") {
+        map.fillRect(30, 1, 1, 16, retro_dungeon::TileType::Wall);
+        for (int i = 0; i < 100; ++i) {
+            REQUIRE(pathfinder.findPath(map, {29, 2}, {31, 2}, path));
+            REQUIRE(path.size() == 32);
+            REQUIRE(pathfinder.findPath(map, {2, 17}, {66, 17}, path));
+            REQUIRE(path.size() == 64);
+        }
+    }
+}
+
+TEST_CASE("A* with diagonal movement", "[pathfinder]") {
+    retro_dungeon::Map map(40, 20);
+    map.fillRect(1, 1, 38, 18, retro_dungeon::TileType::Floor);
+    retro_dungeon::Pathfinder pathfinder(retro_dungeon::Movement::Diagonal);
+    std::vector<retro_dungeon::Position> path;
+
+    SECTION("Octile cost on open floor") {
+        REQUIRE(pathfinder.findPath(map, {1, 1}, {21, 11}, path));
+        requireValidPath(map, {1, 1}, {21, 11}, path);
+        REQUIRE(path.size() == 20);
+        REQUIRE(pathfinder.getPathCost() == 10 * retro_dungeon::Pathfinder::DIAGONAL_COST +
+                                                10 * retro_dungeon::Pathfinder::STRAIGHT_COST);
+    }
+
+    SECTION("Never cuts a wall corner") {
+        map.setTile(6, 5, retro_dungeon::TileType::Wall);
+        REQUIRE(pathfinder.findPath(map, {5, 5}, {6, 6}, path));
+        REQUIRE(path.size() == 2);
+        REQUIRE(path[0] == retro_dungeon::Position{5, 6});
+    }
+}
@@ -63,17 +63,18 @@ TEST_CASE("Player health management", "[player]") {
 
 TEST_CASE("Player inventory", "[player]") {
     retro_dungeon::Player player(1, "Hero", {5, 5});
+    retro_dungeon::ItemStore items;
     
     SECTION("Can add items") {
-        auto item = std::make_shared<retro_dungeon::Item>("Sword", retro_dungeon::ItemType::Weapon, '/', 10, 5, 0);
-        REQUIRE(player.addItem(item));
+        auto sword = items.define({"Sword", retro_dungeon::ItemType::Weapon, '/', 10, 5, 0});
+        REQUIRE(player.addItem(items.create(sword)));
         REQUIRE(player.inventory.size() == 1);
     }
     
     SECTION("Inventory boundary - bug") {
         for (int i = 0; i < 25; ++i) {
-            auto item = std::make_shared<retro_dungeon::Item>("Item" + std::to_string(i), retro_dungeon::ItemType::Potion, '!', 5, 0, 10);
-            player.addItem(item);
+            auto def = items.define({"Item" + std::to_string(i), retro_dungeon::ItemType::Potion, '!', 5, 0, 10});
+            player.addItem(items.create(def));
         }
         REQUIRE(player.inventory.size() <= 20);
     }
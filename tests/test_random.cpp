@@ -1,5 +1,9 @@
 #include <catch2/catch_all.hpp>
 #include "retro_dungeon/game.hpp"
+#include "retro_dungeon/random.hpp"
+#include <algorithm>
+#include <iterator>
+#include <vector>
 
 TEST_CASE("Random integer generation", "[random]") {
     retro_dungeon::DungeonGenerator gen;
@@ -30,4 +34,162 @@ TEST_CASE("Seeded generation is reproducible", "[random]") {
     auto map2 = gen2.generate(60, 20);
     
     REQUIRE(map1->getStairsDown() == map2->getStairsDown());
-}
\ No newline at end of file
+}
+
+TEST_CASE("Derived streams are reproducible and independent", "[random]") {
+    using retro_dungeon::RngStream;
+
+    auto a = retro_dungeon::makeStream(7, 3, RngStream::Spawning);
+    auto b = retro_dungeon::makeStream(7, 3, RngStream::Spawning);
+    auto items = retro_dungeon::makeStream(7, 3, RngStream::Items);
+    auto nextLevel = retro_dungeon::makeStream(7, 4, RngStream::Spawning);
+
+    uint64_t first = a();
+    REQUIRE(first == b());
+    REQUIRE(first != items());
+    REQUIRE(first != nextLevel());
+}
+
+TEST_CASE("SplitMix64 is counter based", "[random]") {
+    retro_dungeon::SplitMix64 stepped(99);
+    retro_dungeon::SplitMix64 skipped(99);
+
+    for (int i = 0; i < 1000; ++i) {
+        stepped();
+    }
+    skipped.discard(1000);
+    REQUIRE(stepped() == skipped());
+
+    SECTION("Split streams diverge from the parent") {
+        retro_dungeon::SplitMix64 parent(5);
+        auto child = parent.split();
+        REQUIRE(child() != parent());
+    }
+}
+
+TEST_CASE("Bounded integers stay in range", "[random]") {
+    retro_dungeon::Xoshiro256StarStar rng(2024);
+
+    SECTION("Every value of a small range is produced") {
+        int counts[7] = {};
+        int outOfRange = 0;
+        for (int i = 0; i < 7000; ++i) {
+            int value = retro_dungeon::uniformInt(rng, 0, 6);
+            if (value < 0 || value > 6) {
+                ++outOfRange;
+                continue;
+            }
+            ++counts[value];
+        }
+        REQUIRE(outOfRange == 0);
+        for (int count : counts) {
+            REQUIRE(count > 800);
+            REQUIRE(count < 1200);
+        }
+    }
+
+    SECTION("Negative and degenerate ranges") {
+        for (int i = 0; i < 100; ++i) {
+            int value = retro_dungeon::uniformInt(rng, -5, -3);
+            REQUIRE(value >= -5);
+            REQUIRE(value <= -3);
+        }
+        REQUIRE(retro_dungeon::uniformInt(rng, 9, 9) == 9);
+    }
+}
+
+TEST_CASE("Generator accepts other engines", "[random]") {
+    static_assert(retro_dungeon::RandomEngine<retro_dungeon::Xoshiro256StarStar>);
+    static_assert(retro_dungeon::RandomEngine<std::mt19937>);
+
+    retro_dungeon::BasicDungeonGenerator<std::mt19937> gen1(777);
+    retro_dungeon::BasicDungeonGenerator<std::mt19937> gen2(777);
+
+    REQUIRE(gen1.generate(60, 20)->getStairsDown() == gen2.generate(60, 20)->getStairsDown());
+}
+
+TEST_CASE("Batch fills match the scalar stream", "[random]") {
+    retro_dungeon::BatchRng rng(1234);
+
+    SECTION("Odd-sized fills continue the same sequence") {
+        std::vector<uint32_t> values(1003);
+        rng.fillBits(std::span(values).first(13));
+        rng.fillBits(std::span(values).subspan(13));
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            REQUIRE(values[i] == rng.valueAt(i));
+        }
+        REQUIRE(rng.getCounter() == values.size());
+    }
+
+    SECTION("Counter wrapping into the high word") {
+        const uint64_t start = (uint64_t{1} << 32) - 5;
+        rng.seek(start);
+        std::vector<uint32_t> values(20);
+        rng.fillBits(values);
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            REQUIRE(values[i] == rng.valueAt(start + i));
+        }
+    }
+
+    SECTION("Same seed, same output") {
+        retro_dungeon::BatchRng other(1234);
+        std::vector<int> a(500), b(500);
+        rng.fillInts(a, 1, 58);
+        other.fillInts(b, 1, 58);
+        REQUIRE(a == b);
+    }
+}
+
+TEST_CASE("Batch fills match known answers", "[random]") {
+    // Computed outside this code base; twelve values cover a full AVX2 or
+    // SSE4.1 block plus a scalar tail.
+    constexpr uint32_t EXPECTED[] = {
+        0xfff34ee9u, 0x7fc91637u, 0xc5ee4ed0u, 0xb5aab058u, 0xaddba871u, 0x02e4b500u,
+        0x5b54dc2fu, 0x98d4c90cu, 0x6ad654a9u, 0x9c365dc4u, 0x346df598u, 0x8aa26633u,
+    };
+    retro_dungeon::BatchRng rng(1234);
+
+    SECTION("Bits") {
+        std::vector<uint32_t> values(std::size(EXPECTED));
+        rng.fillBits(values);
+        REQUIRE(std::equal(values.begin(), values.end(), std::begin(EXPECTED)));
+        REQUIRE(rng.valueAt(5) == EXPECTED[5]);
+    }
+
+    SECTION("Across the high word") {
+        rng.seek((uint64_t{1} << 32) - 2);
+        std::vector<uint32_t> values(4);
+        rng.fillBits(values);
+        REQUIRE(values == std::vector<uint32_t>{0x83371e13u, 0x17d43641u, 0x2d3e3ea4u, 0xf4a5b529u});
+    }
+
+    SECTION("Ints") {
+        std::vector<int> values(std::size(EXPECTED));
+        rng.fillInts(values, 1, 58);
+        REQUIRE(values == std::vector<int>{58, 29, 45, 42, 40, 1, 21, 35, 25, 36, 12, 32});
+    }
+}
+
+TEST_CASE("Batch bounded values stay in range", "[random]") {
+    retro_dungeon::DungeonGenerator generator(99);
+
+    std::vector<int> ints(7000);
+    generator.fillInts(ints, -3, 3);
+    int counts[7] = {};
+    for (int value : ints) {
+        REQUIRE(value >= -3);
+        REQUIRE(value <= 3);
+        ++counts[value + 3];
+    }
+    for (int count : counts) {
+        REQUIRE(count > 800);
+        REQUIRE(count < 1200);
+    }
+
+    std::vector<float> floats(1000);
+    generator.fillFloats(floats);
+    for (float value : floats) {
+        REQUIRE(value >= 0.0f);
+        REQUIRE(value < 1.0f);
+    }
+}
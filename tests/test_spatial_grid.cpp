@@ -0,0 +1,87 @@
+#include <catch2/catch_all.hpp>
+#include "retro_dungeon/spatial_grid.hpp"
+#include <vector>
+
+TEST_CASE("Spatial grid occupancy", "[spatial_grid]") {
+    retro_dungeon::SpatialGrid<int> grid(100, 10);
+
+    REQUIRE(grid.place({3, 4}, 7));
+    REQUIRE(grid.place({70, 9}, 8));
+    REQUIRE(grid.size() == 2);
+
+    SECTION("Lookups") {
+        REQUIRE(grid.at({3, 4}) == 7);
+        REQUIRE(grid.at({70, 9}) == 8);
+        REQUIRE(grid.at({4, 4}) == 0);
+        REQUIRE(grid.at({-1, 4}) == 0);
+        REQUIRE(grid.at({100, 0}) == 0);
+        REQUIRE(grid.isOccupied({3, 4}));
+        REQUIRE_FALSE(grid.isOccupied({3, 5}));
+    }
+
+    SECTION("One occupant per tile") {
+        REQUIRE_FALSE(grid.place({3, 4}, 9));
+        REQUIRE_FALSE(grid.place({0, 10}, 9));
+        REQUIRE(grid.at({3, 4}) == 7);
+        REQUIRE(grid.size() == 2);
+    }
+
+    SECTION("Move") {
+        REQUIRE(grid.move({3, 4}, {64, 4}));
+        REQUIRE(grid.at({64, 4}) == 7);
+        REQUIRE_FALSE(grid.isOccupied({3, 4}));
+        REQUIRE_FALSE(grid.move({64, 4}, {70, 9}));
+        REQUIRE_FALSE(grid.move({3, 4}, {5, 5}));
+        REQUIRE_FALSE(grid.move({64, 4}, {64, -1}));
+        REQUIRE(grid.at({64, 4}) == 7);
+        REQUIRE(grid.size() == 2);
+    }
+
+    SECTION("Remove") {
+        grid.remove({3, 4});
+        grid.remove({3, 4});
+        REQUIRE_FALSE(grid.isOccupied({3, 4}));
+        REQUIRE(grid.size() == 1);
+        REQUIRE(grid.place({3, 4}, 9));
+    }
+}
+
+TEST_CASE("Spatial grid radius queries", "[spatial_grid]") {
+    retro_dungeon::SpatialGrid<int> grid(150, 40);
+    int next = 1;
+    for (int y = 0; y < 40; y += 3) {
+        for (int x = 0; x < 150; x += 5) {
+            grid.place({x, y}, next++);
+        }
+    }
+
+    auto brute = [&](retro_dungeon::Position c, int r) {
+        std::vector<int> found;
+        for (int y = 0; y < 40; ++y) {
+            for (int x = 0; x < 150; ++x) {
+                const int dx = x - c.first;
+                const int dy = y - c.second;
+                if (dx * dx + dy * dy <= r * r && grid.isOccupied({x, y})) {
+                    found.push_back(grid.at({x, y}));
+                }
+            }
+        }
+        return found;
+    };
+
+    const retro_dungeon::Position centers[] = {{0, 0}, {64, 20}, {63, 21}, {149, 39}, {75, -5}};
+    for (auto center : centers) {
+        for (int r : {0, 1, 5, 17, 70}) {
+            std::vector<int> found;
+            grid.forEachInRadius(center, r, [&](retro_dungeon::Position p, int value) {
+                REQUIRE(grid.at(p) == value);
+                found.push_back(value);
+            });
+            REQUIRE(found == brute(center, r));
+        }
+    }
+
+    std::size_t total = 0;
+    grid.forEach([&](retro_dungeon::Position, int) { ++total; });
+    REQUIRE(total == grid.size());
+}
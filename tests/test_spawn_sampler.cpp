@@ -0,0 +1,37 @@
+#include <catch2/catch_all.hpp>
+#include "retro_dungeon/spawn_sampler.hpp"
+#include <set>
+
+TEST_CASE("Spawn sampler", "[spawn_sampler]") {
+    retro_dungeon::Map map(90, 20);
+    map.fillRect(1, 1, 10, 5, retro_dungeon::TileType::Floor);
+    map.fillRect(70, 10, 10, 5, retro_dungeon::TileType::Floor);
+    map.trackWalkableCells();
+
+    retro_dungeon::SpawnSampler sampler;
+    sampler.reset(map);
+    retro_dungeon::SplitMix64 rng(3);
+
+    REQUIRE(sampler.occupy({5, 3}));
+    REQUIRE(!sampler.occupy({5, 3}));
+    REQUIRE(sampler.isOccupied({5, 3}));
+    REQUIRE(!sampler.occupy({-1, 3}));
+
+    SECTION("Draws every free walkable tile exactly once") {
+        std::set<retro_dungeon::Position> seen;
+        for (auto p = sampler.sample(rng); p != retro_dungeon::INVALID_POSITION; p = sampler.sample(rng)) {
+            REQUIRE(map.isWalkable(p.first, p.second));
+            REQUIRE(sampler.isOccupied(p));
+            REQUIRE(seen.insert(p).second);
+        }
+        REQUIRE(seen.size() == 99);
+        REQUIRE(!seen.contains({5, 3}));
+        REQUIRE(sampler.remaining() == 0);
+    }
+
+    SECTION("Batches stop when the level is full") {
+        std::vector<retro_dungeon::Position> out(150);
+        REQUIRE(sampler.sampleBatch(rng, out) == 99);
+        REQUIRE(sampler.sampleBatch(rng, out) == 0);
+    }
+}